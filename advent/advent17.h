@@ -4,6 +4,17 @@
 
 ResultType day_seventeen_testcase_a();
 ResultType day_seventeen_testcase_b();
+ResultType day_seventeen_testcase_c();
+ResultType day_seventeen_testcase_d();
+ResultType day_seventeen_testcase_e();
+ResultType day_seventeen_testcase_f();
+ResultType day_seventeen_testcase_dim_generic(std::size_t dim);
+
+template <std::size_t DIM>
+inline ResultType day_seventeen_testcase_dim()
+{
+	return day_seventeen_testcase_dim_generic(DIM);
+}
 
 ResultType advent_seventeen_p1();
 ResultType advent_seventeen_p2();
@@ -4,6 +4,8 @@
 
 ResultType day_two_p1_testcase();
 ResultType day_two_p2_testcase();
+ResultType day_two_p1_testcase_long();
+ResultType day_two_p2_testcase_long();
 
 ResultType advent_two_p1();
 ResultType advent_two_p2();
@@ -5,11 +5,26 @@
 ResultType day_twentyfour_testcase_a();
 ResultType day_twentyfour_testcase_b_generic(int num_iterations);
 
+ResultType day_twentyfour_testcase_c_generic(int num_iterations);
+ResultType day_twentyfour_testcase_d_generic(int num_iterations);
+
 template <int ITERATIONS>
 inline ResultType day_twentyfour_testcase_b()
 {
 	return day_twentyfour_testcase_b_generic(ITERATIONS);
 }
 
+template <int ITERATIONS>
+inline ResultType day_twentyfour_testcase_c()
+{
+	return day_twentyfour_testcase_c_generic(ITERATIONS);
+}
+
+template <int ITERATIONS>
+inline ResultType day_twentyfour_testcase_d()
+{
+	return day_twentyfour_testcase_d_generic(ITERATIONS);
+}
+
 ResultType advent_twentyfour_p1();
 ResultType advent_twentyfour_p2();
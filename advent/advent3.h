@@ -4,6 +4,7 @@
 
 ResultType day_three_p1_testcase_a();
 ResultType day_three_p2_testcase_a();
+ResultType day_three_testcase_many_slopes();
 
 ResultType advent_three_p1();
 ResultType advent_three_p2();
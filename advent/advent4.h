@@ -3,6 +3,8 @@
 #include "advent_types.h"
 
 ResultType day_four_p1_testcase_a();
+ResultType day_four_p1_testcase_unknown_fields();
+ResultType day_four_p1_testcase_long_names();
 ResultType day_four_p2_testcase_b();
 ResultType day_four_p2_testcase_c();
 
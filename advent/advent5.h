@@ -6,6 +6,9 @@ ResultType day_five_testcase_a();
 ResultType day_five_testcase_b();
 ResultType day_five_testcase_c();
 ResultType day_five_testcase_d();
+ResultType day_five_testcase_long_pass();
+ResultType day_five_testcase_highest();
+ResultType day_five_testcase_gap();
 
 ResultType advent_five_p1();
 ResultType advent_five_p2();
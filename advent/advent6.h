@@ -4,6 +4,7 @@
 
 ResultType day_six_testcase_a();
 ResultType day_six_testcase_b();
+ResultType day_six_testcase_wide_alphabet();
 
 ResultType advent_six_p1();
 ResultType advent_six_p2();
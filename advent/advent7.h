@@ -5,6 +5,7 @@
 ResultType day_seven_testcase_a();
 ResultType day_seven_testcase_b();
 ResultType day_seven_testcase_c();
+ResultType day_seven_testcase_queries();
 
 ResultType advent_seven_p1();
 ResultType advent_seven_p2();
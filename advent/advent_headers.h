@@ -25,3 +25,4 @@
 #include "advent23.h"
 #include "advent24.h"
 #include "advent25.h"
+#include "benchmarks.h"
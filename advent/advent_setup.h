@@ -37,11 +37,16 @@ static const verification_test tests[] =
 	DAY(one, Dummy{},Dummy{}),
 	TESTCASE(day_two_p1_testcase,2),
 	TESTCASE(day_two_p2_testcase,1),
+	TESTCASE(day_two_p1_testcase_long,20000),
+	TESTCASE(day_two_p2_testcase_long,10000),
 	DAY(two,Dummy{},Dummy{}),
 	TESTCASE(day_three_p1_testcase_a,7),
 	TESTCASE(day_three_p2_testcase_a,336),
+	TESTCASE(day_three_testcase_many_slopes,"3,2,7,3,4,2,1,5,2,1"),
 	DAY(three,Dummy{},Dummy{}),
 	TESTCASE(day_four_p1_testcase_a,2),
+	TESTCASE(day_four_p1_testcase_unknown_fields,2),
+	TESTCASE(day_four_p1_testcase_long_names,1),
 	TESTCASE(day_four_p2_testcase_b,0),
 	TESTCASE(day_four_p2_testcase_c,4),
 	DAY(four,Dummy{},Dummy{}),
@@ -49,13 +54,18 @@ static const verification_test tests[] =
 	TESTCASE(day_five_testcase_b,567),
 	TESTCASE(day_five_testcase_c,119),
 	TESTCASE(day_five_testcase_d,820),
+	TESTCASE(day_five_testcase_long_pass,2097153),
+	TESTCASE(day_five_testcase_highest,130),
+	TESTCASE(day_five_testcase_gap,64),
 	DAY(five,Dummy{},Dummy{}),
 	TESTCASE(day_six_testcase_a,11),
 	TESTCASE(day_six_testcase_b,6),
+	TESTCASE(day_six_testcase_wide_alphabet,"6,3"),
 	DAY(six,Dummy{},Dummy{}),
 	TESTCASE(day_seven_testcase_a,4),
 	TESTCASE(day_seven_testcase_b,32),
 	TESTCASE(day_seven_testcase_c,126),
+	TESTCASE(day_seven_testcase_queries,"7,75"),
 	DAY(seven,Dummy{},Dummy{}),
 	TESTCASE(day_eight_testcase_a,5),
 	TESTCASE(day_eight_testcase_b,8),
@@ -105,6 +115,17 @@ static const verification_test tests[] =
 	DAY(sixteen,Dummy{},Dummy{}),
 	TESTCASE(day_seventeen_testcase_a,112),
 	TESTCASE(day_seventeen_testcase_b,848),
+	TESTCASE(day_seventeen_testcase_c,112),
+	TESTCASE(day_seventeen_testcase_d,848),
+	TESTCASE(day_seventeen_testcase_e,112),
+	TESTCASE(day_seventeen_testcase_f,848),
+	TESTCASE(day_seventeen_testcase_dim<2>,5),
+	TESTCASE(day_seventeen_testcase_dim<3>,38),
+	TESTCASE(day_seventeen_testcase_dim<4>,320),
+	TESTCASE(day_seventeen_testcase_dim<5>,2288),
+	TESTCASE(day_seventeen_testcase_dim<6>,15744),
+	TESTCASE(day_seventeen_testcase_dim<7>,106400),
+	TESTCASE(day_seventeen_testcase_dim<8>,709120),
 	DAY(seventeen,Dummy{},Dummy{}),
 	TESTCASE(day_eighteen_testcase_a,71),
 	TESTCASE(day_eighteen_testcase_b,51),
@@ -155,9 +176,44 @@ static const verification_test tests[] =
 	TESTCASE(day_twentyfour_testcase_b<80>, 1373),
 	TESTCASE(day_twentyfour_testcase_b<90>, 1844),
 	TESTCASE(day_twentyfour_testcase_b<100>, 2208),
+	TESTCASE(day_twentyfour_testcase_c<1>, 15),
+	TESTCASE(day_twentyfour_testcase_c<10>, 37),
+	TESTCASE(day_twentyfour_testcase_c<100>, 2208),
+	TESTCASE(day_twentyfour_testcase_d<1>, 15),
+	TESTCASE(day_twentyfour_testcase_d<10>, 37),
+	TESTCASE(day_twentyfour_testcase_d<100>, 2208),
 	DAY(twentyfour,Dummy{},Dummy{}),
 	TESTCASE(day_twentyfive_testcase_a, 14897079),
-	DAY(twentyfive, Dummy{},"MERRY CHRISTMAS!")
+	DAY(twentyfive, Dummy{},"MERRY CHRISTMAS!"),
+	TESTCASE(benchmark_ring_buffer_against_deque, "ok"),
+	TESTCASE(benchmark_spsc_ring_buffer_pipeline, 500000500000),
+	TESTCASE(benchmark_mpmc_ring_buffer_pipeline, 500000500000),
+	TESTCASE(benchmark_concurrent_interner, 1000),
+	TESTCASE(benchmark_int_range_parallel_transform_reduce, Dummy{}),
+	TESTCASE(benchmark_int_range_parallel_uses_threads, "ok"),
+	TESTCASE(benchmark_thread_pool_nested_reduce, 500000500000),
+	TESTCASE(benchmark_thread_pool_parallel_reduce, Dummy{}),
+	TESTCASE(benchmark_memo_against_map, "ok"),
+	TESTCASE(benchmark_memo_constant_hash, "ok"),
+	TESTCASE(benchmark_concurrent_memo_fibonacci, 23416728348467685),
+	TESTCASE(benchmark_isqrt_against_previous, Dummy{}),
+	TESTCASE(benchmark_char_class_against_scalar, "ok"),
+	TESTCASE(benchmark_k_sum_against_brute_force, "ok"),
+	TESTCASE(benchmark_k_sum_thousands_of_values, "ok"),
+	TESTCASE(benchmark_char_count_batch_against_scalar, "ok"),
+	TESTCASE(benchmark_record_range_split, "ok"),
+	TESTCASE(benchmark_sorted_vector_find<1000>, Dummy{}),
+	TESTCASE(benchmark_frozen_sorted_vector_find<1000>, Dummy{}),
+	TESTCASE(benchmark_sorted_vector_find<10000>, Dummy{}),
+	TESTCASE(benchmark_frozen_sorted_vector_find<10000>, Dummy{}),
+	TESTCASE(benchmark_sorted_vector_find<100000>, Dummy{}),
+	TESTCASE(benchmark_frozen_sorted_vector_find<100000>, Dummy{}),
+	TESTCASE(benchmark_sorted_vector_find<1000000>, Dummy{}),
+	TESTCASE(benchmark_frozen_sorted_vector_find<1000000>, Dummy{}),
+	TESTCASE(benchmark_sorted_vector_find<10000000>, Dummy{}),
+	TESTCASE(benchmark_frozen_sorted_vector_find<10000000>, Dummy{}),
+	TESTCASE(benchmark_sorted_vector_find<100000000>, Dummy{}),
+	TESTCASE(benchmark_frozen_sorted_vector_find<100000000>, Dummy{})
 };
 
 #undef ARG
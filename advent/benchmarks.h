@@ -0,0 +1,39 @@
+#pragma once
+
+#include "advent_types.h"
+
+// Benchmarks for the utils. These aren't puzzles, so the default filter skips them.
+// Run them with the filter "benchmark".
+
+ResultType benchmark_sorted_vector_find_generic(std::size_t num_elements);
+ResultType benchmark_frozen_sorted_vector_find_generic(std::size_t num_elements);
+
+ResultType benchmark_ring_buffer_against_deque();
+ResultType benchmark_spsc_ring_buffer_pipeline();
+ResultType benchmark_mpmc_ring_buffer_pipeline();
+ResultType benchmark_concurrent_interner();
+ResultType benchmark_int_range_parallel_transform_reduce();
+ResultType benchmark_int_range_parallel_uses_threads();
+ResultType benchmark_thread_pool_nested_reduce();
+ResultType benchmark_thread_pool_parallel_reduce();
+ResultType benchmark_memo_against_map();
+ResultType benchmark_memo_constant_hash();
+ResultType benchmark_concurrent_memo_fibonacci();
+ResultType benchmark_isqrt_against_previous();
+ResultType benchmark_char_class_against_scalar();
+ResultType benchmark_k_sum_against_brute_force();
+ResultType benchmark_k_sum_thousands_of_values();
+ResultType benchmark_char_count_batch_against_scalar();
+ResultType benchmark_record_range_split();
+
+template <std::size_t NUM_ELEMENTS>
+inline ResultType benchmark_sorted_vector_find()
+{
+	return benchmark_sorted_vector_find_generic(NUM_ELEMENTS);
+}
+
+template <std::size_t NUM_ELEMENTS>
+inline ResultType benchmark_frozen_sorted_vector_find()
+{
+	return benchmark_frozen_sorted_vector_find_generic(NUM_ELEMENTS);
+}
@@ -1,12 +1,12 @@
 #include "../advent/advent1.h"
 
-#include "../utils/sorted_vector.h"
+#include "../utils/k_sum.h"
 #include "../utils/advent_utils.h"
 
 #include <sstream>
 #include <fstream>
-#include <optional>
-#include <algorithm>
+#include <vector>
+#include <cstdint>
 #include <cassert>
 #include <iterator>
 
@@ -15,60 +15,28 @@
 // go into a utility header. (Some stuff is already there.)
 namespace
 {
-	using ValList = utils::sorted_vector<uint16_t>;
+	using ValList = std::vector<int64_t>;
 
-	template <typename SortedIt>
-	std::optional<int> get_value_combination(SortedIt start, SortedIt finish, int target, int num_values)
+	ResultType solve_general(const ValList& data, std::size_t num_values)
 	{
-		assert(num_values > 0);
-		// End condition
-		if (num_values == 1)
-		{
-			if (std::binary_search(start, finish, target))
-			{
-				return target;
-			}
-			else
-			{
-				return std::nullopt;
-			}
-		}
-		for (SortedIt it = start; it != finish; ++it)
-		{
-			const int candidate = *it;
-			const int number_needed = target - candidate;
-			if (candidate > number_needed) // Won't find anything
-			{
-				return std::nullopt;
-			}
-			const auto sub_result = get_value_combination(start + 1, finish, number_needed, num_values - 1);
-			if (sub_result.has_value())
-			{
-				return sub_result.value() * candidate;
-			}
-		}
-		
-		// If we fell out of the loop, there's nothing here.
-		return std::nullopt;
+		const auto result = utils::k_sum_product<int64_t>(data, num_values, 2020);
+		assert(result.has_value());
+		return result.value();
 	}
 
 	ResultType solve_p1_general(const ValList& data)
 	{
-		const auto result = get_value_combination(begin(data),end(data), 2020, 2);
-		assert(result.has_value());
-		return result.value();
+		return solve_general(data, 2);
 	}
 
 	ResultType solve_p2_general(const ValList& data)
 	{
-		const auto result = get_value_combination(begin(data), end(data), 2020, 3);
-		assert(result.has_value());
-		return result.value();
+		return solve_general(data, 3);
 	}
 
-	utils::sorted_vector<uint16_t> make_from_stream(std::istream& input, int max)
+	ValList make_from_stream(std::istream& input, int max)
 	{
-		return utils::sorted_vector<uint16_t>{std::istream_iterator<uint16_t>(input), std::istream_iterator<uint16_t>()};
+		return ValList{ std::istream_iterator<int64_t>(input), std::istream_iterator<int64_t>() };
 	}
 
 	ValList get_testcase_input(int max_value)
@@ -4,6 +4,8 @@
 #include "../utils/istream_line_iterator.h"
 #include "../utils/int_range.h"
 #include "../utils/in_range.h"
+#include "../utils/grid.h"
+#include "../utils/neighbour_offsets.h"
 
 #include <array>
 #include <vector>
@@ -38,57 +40,41 @@ namespace
 		Space next = Space::floor;
 	};
 
+	// The border of floor means immediate neighbours can be read without bounds checks.
 	struct Layout
 	{
-		std::vector<SpaceData> space;
+		grid<SpaceData> space;
 		std::vector<std::size_t> chair_indices;
-		std::size_t width = 0;
 	};
 
 	Layout get_layout(std::istream& input)
 	{
-		Layout result;
-		for (auto line_it = istream_line_iterator(input); line_it != istream_line_iterator(); ++line_it)
-		{
-			std::string line = *line_it;
-			assert(result.width == 0 || result.width == line.size());
-			result.width = line.size();
-			std::transform(begin(line), end(line), std::back_inserter(result.space),
-				[](char c) {return SpaceData{ to_space(c), to_space(c) }; });
-		}
+		std::vector<std::string> lines;
+		std::copy(istream_line_iterator(input), istream_line_iterator(), std::back_inserter(lines));
+		assert(!lines.empty());
 
-		for (auto i : int_range(result.space.size()))
+		Layout result;
+		result.space = grid<SpaceData>{ static_cast<int>(lines[0].size()), static_cast<int>(lines.size()), SpaceData{}, 1 };
+		for (int y = 0; y < result.space.height(); ++y)
 		{
-			if (result.space[i].current != Space::floor)
+			const std::string& line = lines[y];
+			assert(line.size() == lines[0].size());
+			for (int x = 0; x < result.space.width(); ++x)
 			{
-				result.chair_indices.push_back(i);
+				const Space s = to_space(line[x]);
+				result.space.at(x, y) = SpaceData{ s, s };
+				if (s != Space::floor)
+				{
+					result.chair_indices.push_back(result.space.index_of(x, y));
+				}
 			}
 		}
 		return result;
 	}
 
-	Coords get_limit(const Layout& layout)
-	{
-		return Coords{ static_cast<int>(layout.width) , static_cast<int>(layout.space.size() / layout.width) };
-	}
-
-	std::size_t get_cell_index(const Layout& layout, const Coords& loc)
-	{
-		if (!in_range<int>(loc.x, 0, layout.width - 1)) return layout.space.max_size();
-		if (!in_range<int>(loc.y, 0, layout.space.size() / layout.width - 1)) return layout.space.max_size();
-		const std::size_t index = loc.y * layout.width + loc.x;
-		return index;
-	}
-
-	Coords get_cell_coords(const Layout& layout, std::size_t index)
-	{
-		return Coords{ static_cast<int>(index % layout.width) , static_cast<int>(index / layout.width) };
-	}
-
 	Space get_contents(const Layout& layout, const Coords& loc)
 	{
-		const auto index = get_cell_index(layout, loc);
-		return index < layout.space.size() ? layout.space[index].current : Space::empty_seat;
+		return layout.space.in_bounds(loc) ? layout.space[loc].current : Space::empty_seat;
 	}
 
 	bool is_occupied(const Layout& layout, const Coords& loc)
@@ -102,55 +88,53 @@ namespace
 		directional
 	};
 
+	int count_immediate_neighbours(const Layout& layout, std::size_t cell_index)
+	{
+		const auto deltas = make_linear_neighbour_deltas<2>({ 1, layout.space.stride() });
+		int result = 0;
+		for (const auto delta : deltas)
+		{
+			if (layout.space.cell(cell_index + delta).current == Space::occupied_seat)
+			{
+				++result;
+			}
+		}
+		return result;
+	}
+
+	int count_visible_neighbours(const Layout& layout, std::size_t cell_index)
+	{
+		const Coords coords = layout.space.coords_of(cell_index);
+		int result = 0;
+		for (const auto& offset : neighbour_offsets<2>)
+		{
+			const Coords direction{ offset[0], offset[1] };
+			Coords test_coords = coords + direction;
+			while (get_contents(layout, test_coords) == Space::floor)
+			{
+				test_coords += direction;
+			}
+			if (is_occupied(layout, test_coords))
+			{
+				++result;
+			}
+		}
+		return result;
+	}
+
 	Layout calculate_next_iteration(Layout layout, int sit_threshold, int stand_threshold, NeighbourBehaviour behaviour)
 	{
 		for (std::size_t cell_index : layout.chair_indices)
 		{
-			SpaceData& cell = layout.space[cell_index];
-			const Coords& coords = get_cell_coords(layout, cell_index);
+			SpaceData& cell = layout.space.cell(cell_index);
 			const Space current = cell.current;
 			Space& next = cell.next;
 			next = current;
 			assert(current == Space::empty_seat || current == Space::occupied_seat);
-			const std::array<Coords, 8> directions {
-				Coords::up(),
-				Coords::up() + Coords::right(),
-				Coords::right(),
-				Coords::right() + Coords::down(),
-				Coords::down(),
-				Coords::down() + Coords::left(),
-				Coords::left(),
-				Coords::left() + Coords::up()
-			};
-
-			auto get_neighbour = [behaviour, &coords, &layout](const Coords& direction)
-			{
-				if (behaviour == NeighbourBehaviour::immediate)
-				{
-					return coords + direction;
-				}
-
-				const Coords limit = get_limit(layout);
-				for (int i = 1; true; ++i)
-				{
-					const Coords test_coords = coords + i * direction;
-					if (!in_range(test_coords.x, 0, limit.x)) return test_coords;
-					if (!in_range(test_coords.y, 0, limit.y)) return test_coords;
-					if (get_contents(layout, test_coords) != Space::floor) return test_coords;
-				}
-				assert(false);
-				return Coords{};
-			};
 
-			std::array<Coords, 8> neighbours;
-			std::transform(begin(directions), end(directions), begin(neighbours), get_neighbour);
-
-			auto is_seat_occupied = [&layout](const Coords& c)
-			{
-				return is_occupied(layout, c);
-			};
-
-			const auto neighbours_occupied = std::count_if(begin(neighbours), end(neighbours), is_seat_occupied);
+			const auto neighbours_occupied = behaviour == NeighbourBehaviour::immediate
+				? count_immediate_neighbours(layout, cell_index)
+				: count_visible_neighbours(layout, cell_index);
 			if (neighbours_occupied <= sit_threshold)
 			{
 				next = Space::occupied_seat;
@@ -167,7 +151,7 @@ namespace
 	{
 		for (auto& i : layout.chair_indices)
 		{
-			SpaceData& sd = layout.space[i];
+			SpaceData& sd = layout.space.cell(i);
 			sd.current = sd.next;
 		}
 		return layout;
@@ -177,7 +161,7 @@ namespace
 	{
 		return std::any_of(begin(layout.chair_indices), end(layout.chair_indices),
 			[&layout](std::size_t i) {
-			const SpaceData data = layout.space[i];
+			const SpaceData data = layout.space.cell(i);
 			return data.current != data.next;
 		});
 	}
@@ -186,10 +170,13 @@ namespace
 	{
 #if 0
 #ifndef NDEBUG
-		for (auto i : int_range(layout.space.size()))
+		for (auto y : int_range(layout.space.height()))
 		{
-			if (i % layout.width == 0) std::cout << '\n';
-			std::cout << to_char(layout.space[i].current);
+			for (const SpaceData& sd : layout.space.row(y))
+			{
+				std::cout << to_char(sd.current);
+			}
+			std::cout << '\n';
 		}
 		std::string dummy;
 		std::getline(std::cin, dummy);
@@ -211,7 +198,7 @@ namespace
 			layout = update_to_next_iteration(std::move(layout));
 		}
 		return std::count_if(begin(layout.chair_indices), end(layout.chair_indices),
-			[&layout](std::size_t i) {return layout.space[i].current == Space::occupied_seat; });
+			[&layout](std::size_t i) {return layout.space.cell(i).current == Space::occupied_seat; });
 	}
 
 	int solve_p1(std::istream& input)
@@ -22,6 +22,16 @@ namespace
 		uint64_t wait_time = std::numeric_limits<uint64_t>::max();
 	};
 
+	struct LargestIdFirst
+	{
+		bool operator()(const BusData& a, const BusData& b) const noexcept
+		{
+			return a.id > b.id;
+		}
+	};
+
+	using BusList = sorted_vector<BusData, LargestIdFirst>;
+
 	uint64_t get_wait_time(uint64_t id, uint64_t start_time)
 	{
 		const auto cycles = start_time / id;
@@ -87,10 +97,10 @@ ResultType advent_thirteen_p1()
 
 namespace
 {
-	sorted_vector<BusData> get_all_buses(std::istream& input)
+	BusList get_all_buses(std::istream& input)
 	{
 		get_start_time(input); // And discard it.
-		sorted_vector<BusData> result([](const BusData& a, const BusData& b) {return a.id > b.id; });
+		BusList result;
 		uint64_t mod = 0;
 		for (auto it = istream_line_iterator{ input,',' }; it != istream_line_iterator{}; ++it)
 		{
@@ -127,7 +137,7 @@ namespace
 		}
 	}
 
-	uint64_t solve_p2(const sorted_vector<BusData>& buses)
+	uint64_t solve_p2(const BusList& buses)
 	{
 		const uint64_t increment = buses.front().id;
 		const uint64_t initial_test_value = increment - buses.front().wait_time;
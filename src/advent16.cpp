@@ -3,15 +3,18 @@
 #include "../utils/in_range.h"
 #include "../utils/split_string.h"
 #include "../utils/istream_line_iterator.h"
-#include "../utils/swap_remove.h"
 #include "../utils/int_range.h"
 #include "../utils/to_value.h"
+#include "../utils/interner.h"
+#include "../utils/dense_bitset.h"
+#include "../utils/thread_pool.h"
 
 #include <vector>
-#include <unordered_map>
 #include <numeric>
 #include <algorithm>
 #include <iostream>
+#include <optional>
+#include <string>
 
 namespace
 {
@@ -19,7 +22,15 @@ namespace
 	using TicketNoNames = std::vector<ValType>;
 	using Range = std::pair<ValType, ValType>;
 	using Constraint = std::pair<Range,Range>;
-	using TicketData = std::unordered_map<std::string, Constraint>;
+	using FieldId = utils::interner::id_type;
+
+	// Field IDs index into constraints.
+	struct TicketData
+	{
+		utils::interner field_names;
+		std::vector<Constraint> constraints;
+		std::size_t size() const noexcept { return constraints.size(); }
+	};
 
 	bool validate_value(ValType val, const Range& range)
 	{
@@ -33,8 +44,8 @@ namespace
 
 	bool is_reasonable_value(ValType val, const TicketData& td)
 	{
-		const auto result = std::any_of(begin(td), end(td),
-			[val](const TicketData::value_type& constraint) {return validate_value(val, constraint.second); });
+		const auto result = std::any_of(begin(td.constraints), end(td.constraints),
+			[val](const Constraint& constraint) {return validate_value(val, constraint); });
 		return result;
 	}
 
@@ -69,13 +80,15 @@ namespace
 		std::istringstream line_stream{ std::move(line) };
 		std::string field_name;
 		std::getline(line_stream, field_name, ':');
-		assert(td.find(field_name) == end(td));
+		assert(!td.field_names.contains(field_name));
+		const FieldId field_id = td.field_names.intern(field_name);
+		assert(field_id == td.constraints.size());
 
 		std::string range1, says_or, range2;
 		line_stream >> range1 >> says_or >> range2;
 		assert(says_or == "or");
 
-		td[field_name] = std::make_pair(extract_range(range1), extract_range(range2));
+		td.constraints.push_back(std::make_pair(extract_range(range1), extract_range(range2)));
 
 		return true;
 	}
@@ -129,13 +142,13 @@ namespace
 	ValType solve_p1(std::istream& input)
 	{
 		const auto [ticket_data, unused_dummy] = process_input_headers(input);
-		auto transform_op = [&ticket_data](std::string line)
+		auto transform_op = [&ticket_data](std::string_view line)
 		{
-			TicketNoNames t = extract_ticket(std::move(line));
+			const TicketNoNames t = extract_ticket(line);
 			return sum_invalid_values(t, ticket_data);
 		};
-		return std::transform_reduce(utils::istream_line_iterator{ input }, utils::istream_line_iterator{},
-			ValType{ 0 }, std::plus<ValType>{}, transform_op);
+		const std::vector<std::string> lines(utils::istream_line_iterator{ input }, utils::istream_line_iterator{});
+		return utils::parallel_reduce(lines, ValType{ 0 }, std::plus<ValType>{}, transform_op);
 	}
 }
 
@@ -153,39 +166,31 @@ ResultType advent_sixteen_p1()
 
 namespace
 {
-	using TicketNames = std::unordered_map<std::string, ValType>;
+	// The names point into the TicketData's field_names.
+	using TicketNames = std::vector<std::pair<std::string_view, ValType>>;
 
-	using PossibilityMatrix = std::vector<std::vector<std::string>>;
+	// For each position on the ticket, the set of fields it could still be.
+	using Possibilities = utils::dynamic_bitset;
+	using PossibilityMatrix = std::vector<Possibilities>;
 
 	// Return true if this solves this particular field i.e. possibilities goes from size > 1 to size == 1.
-	bool process_field_possibilities(std::vector<std::string>& possibilities, const TicketData& td, ValType val)
+	bool process_field_possibilities(Possibilities& possibilities, const TicketData& td, ValType val)
 	{
-		if (possibilities.size() == 1)
+		if (possibilities.count() == 1)
 		{
 			return false;
 		}
 
-		std::size_t i = 0;
-		while (i < possibilities.size())
+		possibilities.for_each_set_bit([&possibilities, &td, val](std::size_t field)
 		{
-			const std::string& field = possibilities[i];
-			const auto constraint_it = td.find(field);
-			assert(constraint_it != end(td));
-			const Constraint& constraint = constraint_it->second;
-			const bool is_valid = validate_value(val, constraint);
-
-			if (is_valid)
-			{
-				++i;
-				continue;
-			}
-			else
+			assert(field < td.constraints.size());
+			if (!validate_value(val, td.constraints[field]))
 			{
-				utils::swap_remove(possibilities, begin(possibilities) + i);
-				assert(!possibilities.empty());
+				possibilities.reset(field);
 			}
-		}
-		return possibilities.size() == 1;
+		});
+		assert(possibilities.any());
+		return possibilities.count() == 1;
 	}
 
 	bool is_valid_ticket(const TicketData& td, const TicketNoNames& ticket)
@@ -200,30 +205,28 @@ namespace
 	void handle_single_possibilities(PossibilityMatrix& pm, std::size_t index)
 	{
 		assert(index < pm.size());
-		assert(pm[index].size() == 1);
-		const std::string& field_name = pm[index][0];
+		assert(pm[index].count() == 1);
+		const std::size_t field_id = pm[index].find_first();
 
 		for (auto i : utils::int_range(pm.size()))
 		{
 			if (i == index) continue;
-			std::vector<std::string>& possibilities = pm[i];
-			if (possibilities.size() == 1) continue;
-			utils::swap_remove(possibilities, field_name);
-			if (possibilities.size() == 1)
+			Possibilities& possibilities = pm[i];
+			if (possibilities.count() == 1) continue;
+			possibilities.reset(field_id);
+			if (possibilities.count() == 1)
 			{
 				handle_single_possibilities(pm, i);
 			}
 		}
 	}
 
+	// The ticket must be valid.
 	void process_ticket(PossibilityMatrix& pm, const TicketData& td, const TicketNoNames& ticket)
 	{
 		assert(pm.size() == td.size());
 		assert(pm.size() == ticket.size());
-		if (!is_valid_ticket(td, ticket))
-		{
-			return;
-		}
+		assert(is_valid_ticket(td, ticket));
 		for (auto i : utils::int_range(pm.size()))
 		{
 			if (process_field_possibilities(pm[i], td, ticket[i]))
@@ -233,36 +236,38 @@ namespace
 		}
 	}
 
-	void process_ticket(PossibilityMatrix& pm, const TicketData& td, std::string ticket)
-	{
-		process_ticket(pm, td, extract_ticket(std::move(ticket)));
-	}
-
 	TicketNames decode_ticket(std::istream& input, const TicketData& td, const TicketNoNames& my_ticket)
 	{
 		assert(td.size() == my_ticket.size());
-		PossibilityMatrix possibilities = [&td]()
-		{
-			std::vector<std::string> all_fields;
-			all_fields.reserve(td.size());
-			std::transform(begin(td), end(td), std::back_inserter(all_fields),
-				[](const TicketData::value_type& tdv) {return tdv.first; });
-			return PossibilityMatrix(td.size(), all_fields);
-		}();
-
-		std::for_each(utils::istream_line_iterator{ input }, utils::istream_line_iterator{},
-			[&td, &possibilities](std::string line)
+		PossibilityMatrix possibilities(td.size(), Possibilities(td.size(), true));
+
+		// Parsing and checking the tickets is independent, so do that on many threads.
+		// Narrowing down the possibilities depends on the order, so that stays on this one.
+		const std::vector<std::string> lines(utils::istream_line_iterator{ input }, utils::istream_line_iterator{});
+		std::vector<std::optional<TicketNoNames>> tickets(lines.size());
+		utils::parallel_for(utils::int_range(lines.size()), [&](std::size_t i)
 		{
-			process_ticket(possibilities, td, std::move(line));
+			TicketNoNames ticket = extract_ticket(lines[i]);
+			if (is_valid_ticket(td, ticket))
+			{
+				tickets[i] = std::move(ticket);
+			}
 		});
+		for (const auto& ticket : tickets)
+		{
+			if (ticket.has_value())
+			{
+				process_ticket(possibilities, td, *ticket);
+			}
+		}
 
 		TicketNames result;
-		std::transform(std::make_move_iterator(begin(possibilities)),
-			std::make_move_iterator(end(possibilities)), begin(my_ticket), std::inserter(result, begin(result)),
-			[](std::vector<std::string> possibilities, ValType val)
+		result.reserve(possibilities.size());
+		std::transform(begin(possibilities), end(possibilities), begin(my_ticket), std::back_inserter(result),
+			[&td](const Possibilities& possibilities, ValType val)
 		{
-			assert(possibilities.size() == 1);
-			return std::make_pair(std::move(possibilities[0]), val);
+			assert(possibilities.count() == 1);
+			return std::make_pair(td.field_names[static_cast<FieldId>(possibilities.find_first())], val);
 		});
 		return result;
 	}
@@ -295,8 +300,7 @@ ResultType day_sixteen_testcase_b()
 {
 	auto input = utils::open_testcase_input(16,'b');
 	const auto [td, my_ticket] = process_input_headers(input);
-	const TicketNames decoded = decode_ticket(input, td, my_ticket);
-	std::vector<std::pair<std::string,ValType>> result_data{ begin(decoded),end(decoded) };
+	TicketNames result_data = decode_ticket(input, td, my_ticket);
 	std::sort(begin(result_data), end(result_data));
 	std::ostringstream result_oss;
 	std::transform(begin(result_data), end(result_data), std::ostream_iterator<std::string>{result_oss},
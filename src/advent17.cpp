@@ -4,6 +4,7 @@
 #include "../utils/in_range.h"
 #include "../utils/istream_line_iterator.h"
 #include "../utils/conway_simulation.h"
+#include "../utils/hashed_conway_simulation.h"
 
 #include <set>
 #include <array>
@@ -26,6 +27,7 @@ namespace
 	using utils::int_range;
 	using utils::istream_line_iterator;
 	using utils::conway_simulation;
+	using utils::hashed_conway_simulation;
 
 	template <std::size_t DIM>
 	using PointData = typename conway_simulation<DIM>::PointData;
@@ -34,6 +36,19 @@ namespace
 	template <std::size_t DIM>
 	using CoordType = typename conway_simulation<DIM>::CoordType;
 
+	template <std::size_t DIM>
+	class incremental_conway_simulation : public conway_simulation<DIM>
+	{
+	public:
+		incremental_conway_simulation(PointData<DIM> active_points,
+			std::size_t turn_on_min, std::size_t turn_on_max,
+			std::size_t stay_on_min, std::size_t stay_on_max)
+			: conway_simulation<DIM>{ std::move(active_points),
+				turn_on_min, turn_on_max, stay_on_min, stay_on_max,
+				typename conway_simulation<DIM>::Space{}, utils::conway_tick_mode::incremental }
+		{}
+	};
+
 	std::istringstream get_testcase_input()
 	{
 		return std::istringstream{
@@ -54,7 +69,7 @@ namespace
 			{
 				Coord<DIM> active_point;
 				std::fill(begin(active_point), end(active_point), 0);
-				assert(active_point.size() > 2);
+				assert(active_point.size() >= 2);
 				active_point[0] = line_position;
 				active_point[1] = line_num;
 				result.push_back(active_point);
@@ -67,8 +82,8 @@ namespace
 		return result;
 	}
 
-	template <std::size_t DIM>
-	conway_simulation<DIM> extract_initial_state(std::istream& input)
+	template <std::size_t DIM, typename Simulation>
+	Simulation extract_initial_state(std::istream& input)
 	{
 		PointData<DIM> result;
 		CoordType<DIM> line_num = 0;
@@ -78,35 +93,37 @@ namespace
 			std::copy(begin(line_result), end(line_result), std::back_inserter(result));
 		};
 		std::for_each(istream_line_iterator{ input }, istream_line_iterator{}, process_line);
-		return conway_simulation<DIM>{std::move(result), 3, 3, 2, 3};
+		return Simulation{std::move(result), 3, 3, 2, 3};
 	}
 
-	template <std::size_t DIM>
-	std::size_t solve_generic(std::istream& input)
+	template <std::size_t DIM, typename Simulation>
+	std::size_t solve_generic(std::istream& input, int num_cycles = 6)
 	{
-		auto state = extract_initial_state<DIM>(input);
-		for (auto i : int_range(6))
+		auto state = extract_initial_state<DIM, Simulation>(input);
+		for (auto i : int_range(num_cycles))
 		{
 			state.tick();
 		}
 		return state.get_active_points().size();
 	}
 
+	template <template <std::size_t> typename Simulation = hashed_conway_simulation>
 	std::size_t solve_p1(std::istream& input)
 	{
-		return solve_generic<3>(input);
+		return solve_generic<3, Simulation<3>>(input);
 	}
 
+	template <template <std::size_t> typename Simulation = hashed_conway_simulation>
 	std::size_t solve_p2(std::istream& input)
 	{
-		return solve_generic<4>(input);
+		return solve_generic<4, Simulation<4>>(input);
 	}
 }
 
 ResultType day_seventeen_testcase_a()
 {
 	auto input = get_testcase_input();
-	return solve_p1(input);
+	return solve_p1<conway_simulation>(input);
 }
 
 ResultType advent_seventeen_p1()
@@ -118,7 +135,58 @@ ResultType advent_seventeen_p1()
 ResultType day_seventeen_testcase_b()
 {
 	auto input = get_testcase_input();
-	return solve_p2(input);
+	return solve_p2<conway_simulation>(input);
+}
+
+ResultType day_seventeen_testcase_c()
+{
+	auto input = get_testcase_input();
+	return solve_p1<hashed_conway_simulation>(input);
+}
+
+ResultType day_seventeen_testcase_d()
+{
+	auto input = get_testcase_input();
+	return solve_p2<hashed_conway_simulation>(input);
+}
+
+// Runs the testcase for 3 cycles in 2 to 8 dimensions, mostly to time how the neighbour loops scale.
+// (6 cycles in 8 dimensions takes hours.)
+ResultType day_seventeen_testcase_dim_generic(std::size_t dim)
+{
+	auto input = get_testcase_input();
+	switch (dim)
+	{
+	case 2:
+		return solve_generic<2, hashed_conway_simulation<2>>(input, 3);
+	case 3:
+		return solve_generic<3, hashed_conway_simulation<3>>(input, 3);
+	case 4:
+		return solve_generic<4, hashed_conway_simulation<4>>(input, 3);
+	case 5:
+		return solve_generic<5, hashed_conway_simulation<5>>(input, 3);
+	case 6:
+		return solve_generic<6, hashed_conway_simulation<6>>(input, 3);
+	case 7:
+		return solve_generic<7, hashed_conway_simulation<7>>(input, 3);
+	case 8:
+		return solve_generic<8, hashed_conway_simulation<8>>(input, 3);
+	default:
+		assert(false);
+		return 0;
+	}
+}
+
+ResultType day_seventeen_testcase_e()
+{
+	auto input = get_testcase_input();
+	return solve_p1<incremental_conway_simulation>(input);
+}
+
+ResultType day_seventeen_testcase_f()
+{
+	auto input = get_testcase_input();
+	return solve_p2<incremental_conway_simulation>(input);
 }
 
 ResultType advent_seventeen_p2()
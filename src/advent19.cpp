@@ -5,12 +5,17 @@
 #include "../utils/split_string.h"
 #include "../utils/istream_line_iterator.h"
 #include "../utils/int_range.h"
+#include "../utils/thread_pool.h"
+#include "../utils/memo.h"
+#include "../utils/hash_combine.h"
 
 #include <vector>
 #include <variant>
 #include <algorithm>
 #include <unordered_map>
 #include <optional>
+#include <functional>
+#include <string>
 
 #ifndef NDEBUG
 #define DAY19DEBUG 0
@@ -171,7 +176,28 @@ namespace
 	// If the parse is unsuccessful, empty.
 	using RuleCheckResult = std::vector<std::string_view>;
 
-	RuleCheckResult check_rule_by_id(const RuleSet& rules, RuleID id, std::string_view input);
+	// Lines often end the same way, so the cache is shared by all of them and keyed by the text
+	// rather than its position. A cached result may point into a different line from the one being
+	// checked, but only the contents of the remaining text matter.
+	struct RuleQuery
+	{
+		RuleID id = 0;
+		std::string_view input;
+		bool operator==(const RuleQuery&) const noexcept = default;
+	};
+
+	struct RuleQueryHash
+	{
+		std::size_t operator()(const RuleQuery& query) const noexcept
+		{
+			return static_cast<std::size_t>(utils::hash_combine(std::hash<std::string_view>{}(query.input), query.id));
+		}
+	};
+
+	using RuleCache = utils::concurrent_memo<RuleQuery, RuleCheckResult, RuleQueryHash>;
+	constexpr std::size_t RULE_CACHE_SIZE = 1 << 16;
+
+	RuleCheckResult check_rule_by_id(const RuleSet& rules, RuleCache& cache, RuleID id, std::string_view input);
 
 	RuleCheckResult check_rule_pattern(const PatternRule& rule, std::string_view input)
 	{
@@ -192,6 +218,7 @@ namespace
 
 	RuleCheckResult check_rule_sequence(
 		const RuleSet& rules,
+		RuleCache& cache,
 		Sequence::const_iterator first,
 		Sequence::const_iterator last,
 		std::string_view input)
@@ -199,21 +226,21 @@ namespace
 		if (first == last) return RuleCheckResult{ input };
 		RuleCheckResult result;
 		const RuleID id = *first;
-		const RuleCheckResult id_outcome = check_rule_by_id(rules, id, input);
+		const RuleCheckResult id_outcome = check_rule_by_id(rules, cache, id, input);
 		for (const std::string_view& remaining : id_outcome)
 		{
-			const RuleCheckResult parse_outcome = check_rule_sequence(rules, first + 1, last, remaining);
+			const RuleCheckResult parse_outcome = check_rule_sequence(rules, cache, first + 1, last, remaining);
 			std::copy(begin(parse_outcome), end(parse_outcome), std::back_inserter(result));
 		}
 		return result;
 	}
 
-	RuleCheckResult check_rule_sequence(const RuleSet& rules, const Sequence& sequence, std::string_view input)
+	RuleCheckResult check_rule_sequence(const RuleSet& rules, RuleCache& cache, const Sequence& sequence, std::string_view input)
 	{
-		return check_rule_sequence(rules, begin(sequence), end(sequence), input);
+		return check_rule_sequence(rules, cache, begin(sequence), end(sequence), input);
 	}
 
-	RuleCheckResult check_rule_sequence_option(const RuleSet& rules, const SequenceOption& sequence_option, std::string_view input)
+	RuleCheckResult check_rule_sequence_option(const RuleSet& rules, RuleCache& cache, const SequenceOption& sequence_option, std::string_view input)
 	{
 		if (auto pPattern = std::get_if<PatternRule>(&sequence_option))
 		{
@@ -221,21 +248,21 @@ namespace
 		}
 		auto pSequence = std::get_if<Sequence>(&sequence_option);
 		assert(pSequence != nullptr);
-		return check_rule_sequence(rules, *pSequence, input);
+		return check_rule_sequence(rules, cache, *pSequence, input);
 	}
 
-	RuleCheckResult check_calling_rule(const RuleSet& rules, const CallingRule& calling_rule, std::string_view input)
+	RuleCheckResult check_calling_rule(const RuleSet& rules, RuleCache& cache, const CallingRule& calling_rule, std::string_view input)
 	{
 		RuleCheckResult result;
 		for (const SequenceOption& sequence_option : calling_rule)
 		{
-			const auto sequence_result = check_rule_sequence_option(rules, sequence_option, input);
+			const auto sequence_result = check_rule_sequence_option(rules, cache, sequence_option, input);
 			std::copy(begin(sequence_result), end(sequence_result), std::back_inserter(result));
 		}
 		return result;
 	}
 	
-	RuleCheckResult check_rule_by_id(const RuleSet& rules, RuleID id, std::string_view input)
+	RuleCheckResult check_rule_by_id(const RuleSet& rules, RuleCache& cache, RuleID id, std::string_view input)
 	{
 		assert(id < rules.size());
 		const Rule& rule = rules[id];
@@ -245,7 +272,10 @@ namespace
 		}
 		else if (auto pCalling = get_as_calling_rule(rule))
 		{
-			return check_calling_rule(rules, *pCalling, input);
+			return cache.get_or_compute(RuleQuery{ id, input }, [&]()
+			{
+				return check_calling_rule(rules, cache, *pCalling, input);
+			});
 		}
 		else
 		{
@@ -254,9 +284,9 @@ namespace
 		}
 	}
 
-	bool check_rule(const RuleSet& rules, RuleID id, std::string_view input)
+	bool check_rule(const RuleSet& rules, RuleCache& cache, RuleID id, std::string_view input)
 	{
-		const auto result = check_rule_by_id(rules, id, input);
+		const auto result = check_rule_by_id(rules, cache, id, input);
 		const bool passes = !result.empty() && std::any_of(begin(result), end(result),
 			[](std::string_view r) {return r.empty(); });
 #if DAY19DEBUG
@@ -267,14 +297,16 @@ namespace
 
 	auto solve_generic(const RuleSet& rules, RuleID initial_id,std::istream& input)
 	{
-		auto line_passes = [&rules,initial_id](std::string_view line)
+		// Each line is matched independently, so read them all and share them out between threads.
+		// The lines must outlive the cache, as its keys and results point into them.
+		const std::vector<std::string> lines(utils::istream_line_iterator{ input }, utils::istream_line_iterator{});
+		RuleCache cache{ RULE_CACHE_SIZE };
+		auto line_passes = [&rules, &cache, initial_id](std::string_view line)
 		{
-			return check_rule(rules, 0, line);
+			return check_rule(rules, cache, 0, line);
 		};
-		return std::count_if(
-			utils::istream_line_iterator{ input },
-			utils::istream_line_iterator{},
-			line_passes);
+		return utils::parallel_reduce(lines, int64_t{ 0 }, std::plus<int64_t>{},
+			[&line_passes](const std::string& line) { return line_passes(line) ? int64_t{ 1 } : int64_t{ 0 }; });
 	}
 
 	auto solve_p1(std::istream& input)
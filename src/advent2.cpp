@@ -1,108 +1,196 @@
 #include "../advent/advent2.h"
-#include "../utils/istream_line_iterator.h"
 #include "../utils/advent_utils.h"
+#include "../utils/char_class.h"
+#include "../utils/char_count_batch.h"
+#include "../utils/record_range.h"
 
 #include <string>
+#include <string_view>
 #include <algorithm>
 #include <vector>
 #include <sstream>
+#include <charconv>
+#include <cstdint>
 #include <cassert>
 #include <fstream>
 
 namespace
 {
+	// The password points into the input buffer, so is only valid until the next read.
 	struct PasswordData
 	{
-		std::string password;
+		std::string_view password;
 		int min_occurance = 0;
 		int max_occurance = 0;
 		char reference = 0;
 	};
 
+	struct ValidCounts
+	{
+		int64_t p1 = 0;
+		int64_t p2 = 0;
+	};
+
 	bool validate_password_p1(const PasswordData& pd)
 	{
-		const int ref_count = std::count(begin(pd.password), end(pd.password), pd.reference);
+		const auto ref_count = static_cast<int>(utils::count_char(pd.password, pd.reference));
 		return (pd.min_occurance <= ref_count && ref_count <= pd.max_occurance);
 	}
 
 	bool validate_password_p2(const PasswordData& pd)
 	{
+		assert(static_cast<std::size_t>(pd.max_occurance) <= pd.password.size());
 		const bool min_has_ref = pd.password[pd.min_occurance - 1] == pd.reference;
 		const bool max_has_ref = pd.password[pd.max_occurance - 1] == pd.reference;
 		return min_has_ref != max_has_ref;
 	}
 
-	ResultType solve_p1_generic(const std::vector<PasswordData>& passwords)
+	// Entries look like "1-3 a: abcde".
+	PasswordData parse_database_entry(std::string_view entry)
 	{
-		const auto result = std::count_if(begin(passwords), end(passwords), validate_password_p1);
+		PasswordData result;
+		const char* const last = entry.data() + entry.size();
+		std::from_chars_result parsed = std::from_chars(entry.data(), last, result.min_occurance);
+		assert(parsed.ec == std::errc{});
+		assert(parsed.ptr != last && *parsed.ptr == '-');
+		parsed = std::from_chars(parsed.ptr + 1, last, result.max_occurance);
+		assert(parsed.ec == std::errc{});
+		assert(result.min_occurance <= result.max_occurance);
+		const char* const pos = parsed.ptr;
+		assert(last - pos >= 5);
+		assert(pos[0] == ' ' && pos[2] == ':' && pos[3] == ' ');
+		result.reference = pos[1];
+		result.password = std::string_view{ pos + 4, static_cast<std::size_t>(last - pos - 4) };
 		return result;
 	}
 
-	ResultType solve_p2_generic(const std::vector<PasswordData>& passwords)
+	// Policy 1 is checked sixteen passwords at a time. The batch keeps its own copy of each password,
+	// so it can carry on across reads. Passwords too long for it are checked one by one.
+	void check_p1(const PasswordData& pd, utils::char_count_batch& batch, ValidCounts& counts)
 	{
-		const auto result = std::count_if(begin(passwords), end(passwords), validate_password_p2);
-		return result;
+		if (!utils::char_count_batch::fits(pd.password) || pd.max_occurance > UINT8_MAX)
+		{
+			counts.p1 += validate_password_p1(pd) ? 1 : 0;
+			return;
+		}
+		batch.add(pd.password, pd.reference, static_cast<uint8_t>(std::max(pd.min_occurance, 0)), static_cast<uint8_t>(pd.max_occurance));
+		if (batch.full())
+		{
+			counts.p1 += batch.count_in_range();
+			batch.clear();
+		}
 	}
 
-	PasswordData parse_database_entry(std::string entry)
+	void check_database_entry(std::string_view entry, utils::char_count_batch& batch, ValidCounts& counts)
 	{
-		std::istringstream iss{ std::move(entry) };
-		PasswordData result;
-		char hyphen = 0; // Unused.
-		std::string ref_char_str;
-		iss >> result.min_occurance >> hyphen >> result.max_occurance >> ref_char_str >> result.password;
-		assert(result.min_occurance <= result.max_occurance);
-		assert(ref_char_str.size() == 2);
-		assert(ref_char_str[1] == ':');
-		assert(hyphen == '-');
-		result.reference = ref_char_str[0];
-		return result;
+		if (!entry.empty() && entry.back() == '\r')
+		{
+			entry.remove_suffix(1);
+		}
+		if (entry.empty())
+		{
+			return;
+		}
+		const PasswordData pd = parse_database_entry(entry);
+		check_p1(pd, batch, counts);
+		counts.p2 += validate_password_p2(pd) ? 1 : 0;
 	}
 
-	std::vector<PasswordData> get_db_from_stream(std::istream& input)
+	// Reads the input a block at a time and checks each entry against both policies as it goes,
+	// so the memory used doesn't depend on the size of the input. A partial entry at the end of
+	// a block is moved to the front of the buffer and finished off by the next read.
+	ValidCounts count_valid_passwords(std::istream& input)
 	{
-		std::vector<PasswordData> result;
-		std::transform(
-			utils::istream_line_iterator(input),
-			utils::istream_line_iterator(),
-			std::back_inserter(result),
-			parse_database_entry);
+		constexpr std::size_t BUFFER_SIZE = 1 << 16;
+		std::vector<char> buffer(BUFFER_SIZE);
+		utils::char_count_batch batch;
+		ValidCounts result;
+		std::size_t num_kept = 0;
+		while (true)
+		{
+			assert(num_kept < BUFFER_SIZE); // An entry bigger than the buffer.
+			input.read(buffer.data() + num_kept, static_cast<std::streamsize>(BUFFER_SIZE - num_kept));
+			const auto num_read = static_cast<std::size_t>(input.gcount());
+			if (num_read == 0)
+			{
+				break;
+			}
+			const std::string_view data{ buffer.data(), num_kept + num_read };
+			std::size_t line_start = 0;
+			for (std::size_t line_end = data.find('\n'); line_end != std::string_view::npos; line_end = data.find('\n', line_start))
+			{
+				check_database_entry(data.substr(line_start, line_end - line_start), batch, result);
+				line_start = line_end + 1;
+			}
+			num_kept = data.size() - line_start;
+			std::copy(begin(data) + line_start, end(data), begin(buffer));
+		}
+		check_database_entry(std::string_view{ buffer.data(), num_kept }, batch, result);
+		result.p1 += batch.count_in_range();
 		return result;
 	}
 
-	std::vector<PasswordData> get_testcase_input()
+	constexpr std::string_view TESTCASE_INPUT =
+		"1-3 a: abcde\n"
+		"1-3 b: cdefg\n"
+		"2-9 c: ccccccccc";
+
+	ValidCounts get_testcase_counts()
 	{
-		std::istringstream iss{
-			"1-3 a: abcde\n"
-			"1-3 b: cdefg\n"
-			"2-9 c: ccccccccc"
-		};
-		return get_db_from_stream(iss);
+		std::istringstream iss{ std::string{ TESTCASE_INPUT } };
+		return count_valid_passwords(iss);
 	}
 
-	std::vector<PasswordData> get_puzzle_input()
+	// Long enough to need several reads, with entries split across the ends of the blocks.
+	// Every entry ends in "\r\n", to check the '\r' never ends up in a password.
+	ValidCounts get_long_testcase_counts()
+	{
+		std::string input;
+		for (int i = 0; i < 10'000; ++i)
+		{
+			for (const std::string_view entry : utils::line_range{ TESTCASE_INPUT })
+			{
+				input.append(entry);
+				input.append("\r\n");
+			}
+		}
+		std::istringstream iss{ std::move(input) };
+		return count_valid_passwords(iss);
+	}
+
+	ValidCounts get_puzzle_counts()
 	{
 		std::ifstream input = utils::open_puzzle_input(2);
-		return get_db_from_stream(input);
+		return count_valid_passwords(input);
 	}
 }
 
 ResultType day_two_p1_testcase()
 {
-	return solve_p1_generic(get_testcase_input());
+	return get_testcase_counts().p1;
 }
 
 ResultType day_two_p2_testcase()
 {
-	return solve_p2_generic(get_testcase_input());
+	return get_testcase_counts().p2;
+}
+
+ResultType day_two_p1_testcase_long()
+{
+	return get_long_testcase_counts().p1;
+}
+
+ResultType day_two_p2_testcase_long()
+{
+	return get_long_testcase_counts().p2;
 }
 
 ResultType advent_two_p1()
 {
-	return solve_p1_generic(get_puzzle_input());
+	return get_puzzle_counts().p1;
 }
 
 ResultType advent_two_p2()
 {
-	return solve_p2_generic(get_puzzle_input());
+	return get_puzzle_counts().p2;
 }
@@ -8,6 +8,8 @@
 #include "../utils/Coords.h"
 #include "../utils/istream_line_iterator.h"
 #include "../utils/in_range.h"
+#include "../utils/grid.h"
+#include "../utils/thread_pool.h"
 
 #include <string>
 #include <array>
@@ -387,7 +389,8 @@ namespace
 		return result;
 	}
 
-	using Image = std::vector<std::string>;
+	using Image = utils::grid<char>;
+	using ImageView = utils::oriented_view<Image>;
 
 	Image construct_image(std::vector<Tile> tiles)
 	{
@@ -397,8 +400,8 @@ namespace
 		assert(num_tiles_per_side * num_tiles_per_side == tiles.size());
 		const auto num_rows = num_tiles_per_side * tiles.front().options.front().image.size();
 
-		Image result;
-		result.reserve(num_rows);
+		std::vector<std::string> rows;
+		rows.reserve(num_rows);
 		for (const auto& row : solution)
 		{
 			assert(!row.empty());
@@ -418,7 +421,7 @@ namespace
 				}
 			}
 
-			std::transform(begin(section), end(section), std::back_inserter(result),
+			std::transform(begin(section), end(section), std::back_inserter(rows),
 				[num_rows](std::ostringstream& oss)
 			{
 				std::string result = oss.str();
@@ -426,7 +429,13 @@ namespace
 				return result;
 			});
 		}
-		assert(result.size() == num_rows);
+		assert(rows.size() == num_rows);
+
+		Image result{ static_cast<int>(num_rows), static_cast<int>(num_rows) };
+		for (int y = 0; y < result.height(); ++y)
+		{
+			std::copy(begin(rows[y]), end(rows[y]), begin(result.row(y)));
+		}
 		return result;
 	}
 
@@ -491,91 +500,44 @@ namespace
 		return result;
 	}
 	
-	std::array<Signature,8> get_all_signatures(const Signature& base)
-	{
-		std::array<Signature, 8> result;
-		result[0] = base;
-		std::transform(begin(base), end(base), std::back_inserter(result[1]),
-			[](Coords in) {return Coords(in.x, -in.y); });
-		std::transform(begin(base), end(base), std::back_inserter(result[2]),
-			[](Coords in) {return Coords(-in.x, in.y); });
-		std::transform(begin(base), end(base), std::back_inserter(result[3]),
-			[](Coords in) {return Coords(-in.x, -in.y); });
-		std::transform(begin(base), end(base), std::back_inserter(result[4]),
-			[](Coords in) {return Coords(in.y, in.x); });
-		std::transform(begin(base), end(base), std::back_inserter(result[5]),
-			[](Coords in) {return Coords(in.y, -in.x); });
-		std::transform(begin(base), end(base), std::back_inserter(result[6]),
-			[](Coords in) {return Coords(-in.y, in.x); });
-		std::transform(begin(base), end(base), std::back_inserter(result[7]),
-			[](Coords in) {return Coords(-in.y, -in.x); });
-		return result;
-	}
-
-	bool spot_contains_signature(const Image& image, const Signature& sig, Coords loc)
+	bool spot_contains_signature(const ImageView& image, const Signature& sig, Coords loc)
 	{
 		auto is_part_of_signature = [&](Coords offset)
 		{
 			const Coords final_loc = loc + offset;
-			if (!utils::in_range<int>(final_loc.y, 0, static_cast<int>(image.size() - 1)))
-			{
-				return false;
-			}
-			std::string_view line = image[final_loc.y];
-			if (!utils::in_range<int>(final_loc.x, 0, static_cast<int>(line.size() - 1)))
-			{
-				return false;
-			}
-			return line[final_loc.x] == '#';
+			return image.in_bounds(final_loc) && image[final_loc] == '#';
 		};
 		return std::all_of(begin(sig), end(sig), is_part_of_signature);
 	}
 
-	int count_signatures(const Image& image, const Signature& signature, Coords starting_point)
+	int count_signatures(const ImageView& image, const Signature& signature)
 	{
-		int x = starting_point.x;
 		int result = 0;
-		for (int y = starting_point.y; y < static_cast<int>(image.size()); ++y)
+		for (int y = 0; y < image.height(); ++y)
 		{
-			std::string_view line = image[y];
-			for (; x < static_cast<int>(line.size()); ++x)
+			for (int x = 0; x < image.width(); ++x)
 			{
 				if (spot_contains_signature(image, signature, Coords{ x,y }))
 				{
 					++result;
 				}
 			}
-			x = 0;
 		}
 		return result;
 	}
 
-	auto spot_contains_signature(const Image& image, const std::array<Signature, 8>& sigs, Coords loc)
+	// The signature only shows up with the image the right way round, so look at every orientation
+	// of the image rather than every orientation of the signature. The orientations are searched in parallel.
+	int count_signatures(const Image& image, const Signature& signature)
 	{
-		return std::find_if(begin(sigs), end(sigs),
-			[&](const Signature& s)
+		const auto views = utils::all_orientations(image);
+		const auto first_found = [](int left, int right) { return left != 0 ? left : right; };
+		return utils::parallel_reduce(views, 0, first_found, [&signature](const ImageView& view)
 		{
-			return spot_contains_signature(image, s, loc);
+			return count_signatures(view, signature);
 		});
 	}
 
-	int count_signatures(const Image& image, const std::array<Signature, 8>& sigs)
-	{
-		for (auto y : utils::int_range(static_cast<int>(image.size())))
-		{
-			for (auto x : utils::int_range(static_cast<int>(image[y].size())))
-			{
-				const Coords loc{ x, y };
-				auto has_sig_result = spot_contains_signature(image, sigs, loc);
-				if (has_sig_result != end(sigs))
-				{
-					return count_signatures(image, *has_sig_result, loc);
-				}
-			}
-		}
-		return 0;
-	}
-
 	int64_t solve_p1(std::istream& input)
 	{
 		const auto corners = get_corners_from_input(input);
@@ -588,13 +550,14 @@ namespace
 		const Image image = construct_image(std::move(tiles));
 		const auto sea_monster = get_sea_monster_image();
 		const auto sea_monster_sig = get_image_signature(sea_monster);
-		const auto num_sea_monsters = count_signatures(image, get_all_signatures(sea_monster_sig));
+		const auto num_sea_monsters = count_signatures(image, sea_monster_sig);
 
-		const auto num_tiles = std::transform_reduce(begin(image), end(image), 0, std::plus<int>{},
-			[](std::string_view line)
+		int num_tiles = 0;
+		for (int y = 0; y < image.height(); ++y)
 		{
-			return std::count(begin(line), end(line), '#');
-		});
+			const auto row = image.row(y);
+			num_tiles += static_cast<int>(std::count(begin(row), end(row), '#'));
+		}
 
 		return num_tiles - (num_sea_monsters * sea_monster_sig.size());
 	}
@@ -6,11 +6,12 @@
 #include "../utils/istream_line_iterator.h"
 #include "../utils/int_range.h"
 #include "../utils/sorted_vector.h"
+#include "../utils/interner.h"
+#include "../utils/dense_bitset.h"
 
 #include <cassert>
 #include <compare>
 #include <string>
-#include <unordered_map>
 #include <numeric>
 #include <sstream>
 
@@ -19,11 +20,13 @@ namespace
 	using utils::sorted_vector;
 	using utils::split_string;
 	using utils::istream_line_iterator;
+	using NameId = utils::interner::id_type;
+	using IngredientSet = utils::dynamic_bitset;
 
 	struct Allergen
 	{
-		std::string name;
-		sorted_vector<std::string> possible_ingredients;
+		NameId name;
+		IngredientSet possible_ingredients;
 		bool operator<(const Allergen& other) const noexcept
 		{
 			return name < other.name;
@@ -34,7 +37,8 @@ namespace
 		}
 	};
 
-	using IngredientsAndAppearences = std::unordered_map<std::string, int>;
+	// Indexed by ingredient ID.
+	using IngredientsAndAppearences = std::vector<int>;
 	using AllergenList = sorted_vector<Allergen>;
 
 	// Returns list of ingredients (first) and list of allergens (second)
@@ -70,12 +74,7 @@ namespace
 		const auto previous = running_result.find(new_allergen);
 		if (previous != end(running_result))
 		{
-			sorted_vector<std::string> new_possible_ingredients;
-			std::set_intersection(
-				begin(new_allergen.possible_ingredients), end(new_allergen.possible_ingredients),
-				begin(previous->possible_ingredients), end(previous->possible_ingredients),
-				std::back_inserter(new_possible_ingredients));
-			previous->possible_ingredients = std::move(new_possible_ingredients);
+			previous->possible_ingredients &= new_allergen.possible_ingredients;
 		}
 		else
 		{
@@ -85,33 +84,27 @@ namespace
 
 	void combine_ingredients(
 		AllergenList& running_result,
-		const std::vector<std::string_view>& ingredients,
-		const std::vector<std::string_view>& allergens)
+		const IngredientSet& ingredient_set,
+		const std::vector<NameId>& allergens)
 	{
-		const sorted_vector<std::string> ingredient_set = [&ingredients]()
-		{
-			sorted_vector<std::string> result;
-			std::transform(begin(ingredients), end(ingredients), std::back_inserter(result),
-				[](std::string_view sv) {return std::string{ sv }; });
-			return result;
-		}();
-
 		for (auto allergen : allergens)
 		{
-			combine_ingredient(running_result, Allergen{ std::string{allergen},ingredient_set });
+			combine_ingredient(running_result, Allergen{ allergen,ingredient_set });
 		}
 	}
 
 
 	struct IngredientsAndAllergens
 	{
+		utils::interner ingredient_names;
+		utils::interner allergen_names;
 		IngredientsAndAppearences ingredients;
 		AllergenList allergens;
 	};
 
 	AllergenList reduce_possibilities(AllergenList allergens, std::vector<bool>& checked_allergens, std::size_t index)
 	{
-		assert(allergens[index].possible_ingredients.size() == 1);
+		assert(allergens[index].possible_ingredients.count() == 1);
 		assert(index < allergens.size());
 		assert(checked_allergens.size() == allergens.size());
 		if (checked_allergens[index])
@@ -121,14 +114,14 @@ namespace
 
 		checked_allergens[index] = true;
 
-		const std::string& ingredient_name = allergens[index].possible_ingredients[0];
+		const std::size_t ingredient_name = allergens[index].possible_ingredients.find_first();
 		for (auto i : utils::int_range(allergens.size()))
 		{
 			if (i == index) continue;
 			auto& ingredients = allergens[i].possible_ingredients;
-			if (ingredients.size() == 1) continue;
-			ingredients.erase(ingredient_name);
-			if (ingredients.size() == 1)
+			if (ingredients.count() == 1) continue;
+			ingredients.reset(ingredient_name);
+			if (ingredients.count() == 1)
 			{
 				allergens = reduce_possibilities(std::move(allergens), checked_allergens, i);
 			}
@@ -143,73 +136,103 @@ namespace
 		std::vector<bool> checked_allergens(allergens.size(), false);
 		for (auto i : utils::int_range(allergens.size()))
 		{
-			if (allergens[i].possible_ingredients.size() == 1)
+			if (allergens[i].possible_ingredients.count() == 1)
 			{
 				allergens = reduce_possibilities(std::move(allergens), checked_allergens, i);
 			}
 		}
 		for (const auto& a : allergens)
 		{
-			assert(a.possible_ingredients.size() == 1);
+			assert(a.possible_ingredients.count() == 1);
 		}
 		return allergens;
 	}
 
+	std::vector<NameId> intern_all(utils::interner& names, const std::vector<std::string_view>& strings)
+	{
+		std::vector<NameId> result;
+		result.reserve(strings.size());
+		std::transform(begin(strings), end(strings), std::back_inserter(result),
+			[&names](std::string_view str) {return names.intern(str); });
+		return result;
+	}
+
+	struct Food
+	{
+		std::vector<NameId> ingredients;
+		std::vector<NameId> allergens;
+	};
+
 	IngredientsAndAllergens extract_ingredients_and_allergens(std::istream& input)
 	{
-		IngredientsAndAppearences ingredients;
-		AllergenList allergens;
+		IngredientsAndAllergens result;
+		std::vector<Food> foods;
 		std::for_each(istream_line_iterator{ input }, istream_line_iterator{},
-			[&allergens,&ingredients](std::string_view line)
+			[&result,&foods](std::string_view line)
 		{
 			const auto [ingredient_list, allergen_list] = parse_line(line);
-			combine_ingredients(allergens, ingredient_list, allergen_list);
-			for (auto ingredient : ingredient_list)
+			Food food{ intern_all(result.ingredient_names, ingredient_list), intern_all(result.allergen_names, allergen_list) };
+			result.ingredients.resize(result.ingredient_names.size(), 0);
+			for (auto ingredient : food.ingredients)
 			{
-				ingredients[std::string{ ingredient }] += 1;
+				result.ingredients[ingredient] += 1;
 			}
+			foods.push_back(std::move(food));
 		});
-		allergens = reduce_possibilities(std::move(allergens));
-		return IngredientsAndAllergens{ std::move(ingredients), std::move(allergens) };
+
+		// The sets can only be built once every ingredient has an ID.
+		for (const Food& food : foods)
+		{
+			IngredientSet ingredient_set(result.ingredient_names.size());
+			for (auto ingredient : food.ingredients)
+			{
+				ingredient_set.set(ingredient);
+			}
+			combine_ingredients(result.allergens, ingredient_set, food.allergens);
+		}
+		result.allergens = reduce_possibilities(std::move(result.allergens));
+		return result;
 	}
 
+	// Leaves the safe ingredients' counts alone and zeroes the rest.
 	IngredientsAndAppearences get_safe_ingredients(IngredientsAndAllergens input_data)
 	{
 		IngredientsAndAppearences& ingredients = input_data.ingredients;
 		for (const Allergen& allergen : input_data.allergens)
 		{
-			assert(allergen.possible_ingredients.size() == 1);
-			ingredients.erase(allergen.possible_ingredients[0]);
+			assert(allergen.possible_ingredients.count() == 1);
+			ingredients[allergen.possible_ingredients.find_first()] = 0;
 		}
 		return std::move(ingredients);
 	}
 
-	AllergenList extract_allergens(std::istream& input)
-	{
-		return extract_ingredients_and_allergens(input).allergens;
-	}
-
 	int solve_p1(std::istream& input)
 	{
 		IngredientsAndAllergens data = extract_ingredients_and_allergens(input);
 		const IngredientsAndAppearences safe_ingredients = get_safe_ingredients(std::move(data));
-		auto get_num_appearances = [](const IngredientsAndAppearences::value_type& ingredient)
-		{
-			return ingredient.second;
-		};
-		return std::transform_reduce(begin(safe_ingredients), end(safe_ingredients), 0,
-			std::plus<int>{}, get_num_appearances);
+		return std::reduce(begin(safe_ingredients), end(safe_ingredients), 0);
 	}
 
 	std::string solve_p2(std::istream& input)
 	{
-		auto allergens = extract_allergens(input);
+		const IngredientsAndAllergens data = extract_ingredients_and_allergens(input);
+
+		// IDs are in the order the names were first seen, so sort by the names themselves.
+		std::vector<std::pair<std::string_view, std::string_view>> allergen_to_ingredient;
+		allergen_to_ingredient.reserve(data.allergens.size());
+		for (const Allergen& a : data.allergens)
+		{
+			assert(a.possible_ingredients.count() == 1);
+			const auto ingredient = static_cast<NameId>(a.possible_ingredients.find_first());
+			allergen_to_ingredient.emplace_back(data.allergen_names[a.name], data.ingredient_names[ingredient]);
+		}
+		std::sort(begin(allergen_to_ingredient), end(allergen_to_ingredient));
+
 		std::ostringstream output;
-		std::transform(begin(allergens), end(allergens), std::ostream_iterator<std::string>(output, ","),
-			[](const Allergen& a)
+		std::transform(begin(allergen_to_ingredient), end(allergen_to_ingredient), std::ostream_iterator<std::string_view>(output, ","),
+			[](const std::pair<std::string_view, std::string_view>& a)
 		{
-			assert(a.possible_ingredients.size() == 1);
-			return a.possible_ingredients[0];
+			return a.second;
 		});
 		std::string result = output.str();
 		assert(result.back() == ',');
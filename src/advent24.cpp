@@ -4,6 +4,7 @@
 #include "../utils/advent_utils.h"
 #include "../utils/int_range.h"
 #include "../utils/in_range.h"
+#include "../utils/flat_hash_map.h"
 
 #include <string>
 #include <string_view>
@@ -17,6 +18,7 @@ namespace
 {
 	using utils::Coords;
 	using Floor = std::set<Coords>;
+	using HashedFloor = utils::flat_hash_set<Coords>;
 
 	bool is_odd(int in)
 	{
@@ -163,7 +165,8 @@ namespace
 		return result;
 	}
 
-	std::vector<Coords> get_relevant_tiles(const Floor& floor)
+	template <typename FloorType>
+	std::vector<Coords> get_relevant_tiles(const FloorType& floor)
 	{
 		std::vector<Coords> relevant_tiles;
 		relevant_tiles.reserve(7 * floor.size());
@@ -179,49 +182,139 @@ namespace
 		return relevant_tiles;
 	}
 
-	bool is_tile_black(const Floor& floor, const Coords& tile)
+	template <typename FloorType>
+	bool is_tile_black(const FloorType& floor, const Coords& tile)
 	{
 		return floor.contains(tile);
 	}
 
-	auto count_black_neighbours(const Floor& floor, const Coords& tile)
+	template <typename FloorType>
+	auto count_black_neighbours(const FloorType& floor, const Coords& tile)
 	{
 		const auto neighbours = calculate_neighbours(tile);
 		return std::count_if(begin(neighbours), end(neighbours),
 			[&floor](const Coords& n) {return is_tile_black(floor, n); });
 	}
 
-	bool should_tile_be_black(const Floor& floor, const Coords& tile)
+	template <typename FloorType>
+	bool should_tile_be_black(const FloorType& floor, const Coords& tile)
 	{
 		const auto num_neighbours = count_black_neighbours(floor, tile);
 		return is_tile_black(floor, tile) ? utils::in_range(num_neighbours, 1, 2) : num_neighbours == 2;
 	}
 
-	Floor flip_tiles_overnight(const Floor& floor)
+	template <typename FloorType>
+	FloorType flip_tiles_overnight(const FloorType& floor)
 	{
 		const auto tiles_to_check = get_relevant_tiles(floor);
-		Floor result;
-		std::copy_if(begin(tiles_to_check), end(tiles_to_check),std::inserter(result,begin(result)),
-			[&floor](const Coords& tile) {return should_tile_be_black(floor, tile); });
+		FloorType result;
+		for (const Coords& tile : tiles_to_check)
+		{
+			if (should_tile_be_black(floor, tile))
+			{
+				result.insert(tile);
+			}
+		}
 		return result;
 	}
 
+	// Every tile in a fixed box, one byte each. A tile can only turn black next to a black tile,
+	// so the pattern grows by at most one tile per day in each direction and the box can be sized up front.
+	// There is a one tile border that is always white, so neighbours never need bounds checks.
+	class DenseFloor
+	{
+		std::vector<uint8_t> m_tiles;
+		int m_min_x = 0;
+		int m_min_y = 0;
+		int m_width = 0;
+		int m_height = 0;
+		std::size_t m_num_black = 0;
+
+		std::size_t index(int x, int y) const noexcept
+		{
+			return static_cast<std::size_t>(y - m_min_y) * m_width + (x - m_min_x);
+		}
+	public:
+		DenseFloor(const Floor& initial, int margin)
+		{
+			assert(!initial.empty());
+			auto [min_x, max_x] = std::minmax_element(begin(initial), end(initial),
+				[](const Coords& l, const Coords& r) {return l.x < r.x; });
+			m_min_x = min_x->x - margin - 1;
+			m_width = max_x->x + margin + 1 - m_min_x + 1;
+			auto [min_y, max_y] = std::minmax_element(begin(initial), end(initial),
+				[](const Coords& l, const Coords& r) {return l.y < r.y; });
+			m_min_y = min_y->y - margin - 1;
+			m_height = max_y->y + margin + 1 - m_min_y + 1;
+			m_tiles.resize(static_cast<std::size_t>(m_width) * m_height, 0);
+			for (const Coords& c : initial)
+			{
+				m_tiles[index(c.x, c.y)] = 1;
+			}
+			m_num_black = initial.size();
+		}
+
+		std::size_t size() const noexcept { return m_num_black; }
+
+		void flip_tiles_overnight()
+		{
+			std::vector<uint8_t> result(m_tiles.size(), 0);
+			const std::ptrdiff_t w = m_width;
+			// Row parity decides whether the diagonal neighbours are to the left or the right.
+			const std::array<std::ptrdiff_t, 6> even_row_deltas{ -1, 1, -w - 1, -w, w - 1, w };
+			const std::array<std::ptrdiff_t, 6> odd_row_deltas{ -1, 1, -w, -w + 1, w, w + 1 };
+			m_num_black = 0;
+			for (int y = m_min_y + 1; y < m_min_y + m_height - 1; ++y)
+			{
+				const auto& deltas = is_odd(y) ? odd_row_deltas : even_row_deltas;
+				const std::size_t row_start = index(m_min_x, y);
+				for (std::size_t idx = row_start + 1; idx < row_start + m_width - 1; ++idx)
+				{
+					int num_neighbours = 0;
+					for (const auto delta : deltas)
+					{
+						num_neighbours += m_tiles[idx + delta];
+					}
+					const bool black = m_tiles[idx] ? utils::in_range(num_neighbours, 1, 2) : num_neighbours == 2;
+					result[idx] = black ? 1 : 0;
+					m_num_black += black ? 1 : 0;
+				}
+			}
+			m_tiles = std::move(result);
+		}
+	};
+
 	std::size_t solve_p1(std::istream& input)
 	{
 		const auto result = get_black_tiles(input);
 		return result.size();
 	}
 
+	template <typename FloorType>
 	std::size_t solve_p2(std::istream& input, int num_iterations)
 	{
 		assert(num_iterations > 0);
-		Floor floor = get_black_tiles(input);
+		const Floor initial_floor = get_black_tiles(input);
+		FloorType floor;
+		floor.insert(begin(initial_floor), end(initial_floor));
 		for (auto i : utils::int_range(num_iterations))
 		{
 			floor = flip_tiles_overnight(floor);
 		}
 		return floor.size();
 	}
+
+	template <>
+	std::size_t solve_p2<DenseFloor>(std::istream& input, int num_iterations)
+	{
+		assert(num_iterations > 0);
+		DenseFloor floor{ get_black_tiles(input), num_iterations };
+		for (auto i : utils::int_range(num_iterations))
+		{
+			floor.flip_tiles_overnight();
+		}
+		return floor.size();
+	}
 }
 
 ResultType day_twentyfour_testcase_a()
@@ -239,11 +332,23 @@ ResultType advent_twentyfour_p1()
 ResultType day_twentyfour_testcase_b_generic(int num_iterations)
 {
 	auto input = utils::open_testcase_input(24, 'a');
-	return solve_p2(input, num_iterations);
+	return solve_p2<Floor>(input, num_iterations);
+}
+
+ResultType day_twentyfour_testcase_c_generic(int num_iterations)
+{
+	auto input = utils::open_testcase_input(24, 'a');
+	return solve_p2<HashedFloor>(input, num_iterations);
+}
+
+ResultType day_twentyfour_testcase_d_generic(int num_iterations)
+{
+	auto input = utils::open_testcase_input(24, 'a');
+	return solve_p2<DenseFloor>(input, num_iterations);
 }
 
 ResultType advent_twentyfour_p2()
 {
 	auto input = utils::open_puzzle_input(24);
-	return solve_p2(input, 100);
+	return solve_p2<DenseFloor>(input, 100);
 }
@@ -3,6 +3,7 @@
 #include "../utils/advent_utils.h"
 #include "../utils/istream_line_iterator.h"
 #include "../utils/Coords.h"
+#include "../utils/grid.h"
 
 #include <string>
 #include <vector>
@@ -10,11 +11,14 @@
 #include <functional>
 #include <sstream>
 #include <algorithm>
+#include <numeric>
+#include <cstdint>
+#include <cassert>
 
 namespace
 {
 	using Line = std::string;
-	using Map = std::vector<Line>;
+	using Map = utils::bitgrid;
 	using utils::Coords;
 
 	constexpr char EMPTY = '.';
@@ -27,12 +31,19 @@ namespace
 			const auto find_result = s.find(' ');
 			return s.substr(0, find_result);
 		};
-		Map result;
-		std::transform(utils::istream_line_iterator(input), utils::istream_line_iterator(), std::back_inserter(result), clean_input);
-		assert(!result.empty());
-		for (const Line& l : result)
+		std::vector<Line> lines;
+		std::transform(utils::istream_line_iterator(input), utils::istream_line_iterator(), std::back_inserter(lines), clean_input);
+		assert(!lines.empty());
+		Map result{ static_cast<int>(lines[0].size()), static_cast<int>(lines.size()) };
+		for (int y = 0; y < result.height(); ++y)
 		{
-			assert(l.size() == result[0].size());
+			const Line& l = lines[y];
+			assert(l.size() == lines[0].size());
+			for (int x = 0; x < result.width(); ++x)
+			{
+				assert(l[x] == EMPTY || l[x] == TREE);
+				result.set(x, y, l[x] == TREE);
+			}
 		}
 		return result;
 	}
@@ -61,25 +72,57 @@ namespace
 		return stream_to_map(input);
 	}
 
-	int solve_p1_generic(const Map& map, int x_offset, int y_offset)
+	// Counts the trees hit on every slope in one pass down the map.
+	// Each toboggan keeps its own x, wrapped by subtracting the width rather than with %,
+	// and the number of rows left until it next lands.
+	std::vector<int64_t> count_trees(const Map& map, const std::vector<Coords>& slopes)
 	{
-		int current_x = 0;
-		int current_y = 0;
-		int num_trees = 0;
-		while (current_y < static_cast<int>(map.size()))
+		struct Toboggan
 		{
-			const Line& line = map[current_y];
-			const bool is_tree = (line[current_x % line.size()] == TREE);
-			if (is_tree) ++num_trees;
-			current_x += x_offset;
-			current_y += y_offset;
+			int x = 0;
+			int x_step = 0;
+			int y_step = 0;
+			int rows_to_skip = 0;
+		};
+
+		std::vector<Toboggan> toboggans;
+		toboggans.reserve(slopes.size());
+		std::transform(begin(slopes), end(slopes), std::back_inserter(toboggans), [&map](const Coords& slope)
+		{
+			assert(slope.y > 0);
+			// Steps to the left, or of more than a whole width, become the equivalent step right.
+			const int x_step = ((slope.x % map.width()) + map.width()) % map.width();
+			return Toboggan{ 0, x_step, slope.y, 0 };
+		});
+
+		std::vector<int64_t> result(slopes.size(), 0);
+		for (int y = 0; y < map.height(); ++y)
+		{
+			const auto row = map.row(y);
+			for (std::size_t i = 0; i < toboggans.size(); ++i)
+			{
+				Toboggan& toboggan = toboggans[i];
+				if (toboggan.rows_to_skip > 0)
+				{
+					--toboggan.rows_to_skip;
+					continue;
+				}
+				const auto x = static_cast<std::size_t>(toboggan.x);
+				result[i] += static_cast<int64_t>((row[x / Map::BITS_PER_WORD] >> (x % Map::BITS_PER_WORD)) & 1);
+				toboggan.x += toboggan.x_step;
+				if (toboggan.x >= map.width())
+				{
+					toboggan.x -= map.width();
+				}
+				toboggan.rows_to_skip = toboggan.y_step - 1;
+			}
 		}
-		return num_trees;
+		return result;
 	}
 
 	ResultType solve_p1(const Map& map)
 	{
-		return solve_p1_generic(map, 3, 1);
+		return count_trees(map, std::vector<Coords>{ Coords{ 3,1 } }).front();
 	}
 
 	ResultType solve_p2(const Map& map)
@@ -93,16 +136,35 @@ namespace
 			Coords{1,2}
 		};
 
-		std::vector<int> results;
-		results.reserve(paths.size());
-		auto solve_path = [&map](const Coords& c)
+		const std::vector<int64_t> results = count_trees(map, paths);
+		const int64_t result = std::reduce(begin(results), end(results), int64_t{ 1 }, std::multiplies<int64_t>());
+		return result;
+	}
+
+	// Includes steps of nothing, to the left, more than the width and several rows down.
+	ResultType solve_many_slopes(const Map& map)
+	{
+		const std::vector<Coords> paths
 		{
-			return solve_p1_generic(map, c.x, c.y);
+			Coords{0,1},
+			Coords{1,1},
+			Coords{3,1},
+			Coords{5,1},
+			Coords{7,1},
+			Coords{1,2},
+			Coords{2,3},
+			Coords{-1,1},
+			Coords{70,1},
+			Coords{11,4}
 		};
 
-		std::transform(begin(paths), end(paths), std::back_inserter(results), solve_path);
-		const int result = std::reduce(begin(results), end(results), 1, std::multiplies<int>());
-		return result;
+		const std::vector<int64_t> results = count_trees(map, paths);
+		std::ostringstream oss;
+		for (std::size_t i = 0; i < results.size(); ++i)
+		{
+			oss << (i > 0 ? "," : "") << results[i];
+		}
+		return oss.str();
 	}
 }
 
@@ -116,6 +178,11 @@ ResultType day_three_p2_testcase_a()
 	return solve_p2(get_testcase_a_input());
 }
 
+ResultType day_three_testcase_many_slopes()
+{
+	return solve_many_slopes(get_testcase_a_input());
+}
+
 ResultType advent_three_p1()
 {
 	return solve_p1(get_puzzle_input());
@@ -1,84 +1,156 @@
 #include "../advent/advent4.h"
 #include "../utils/advent_utils.h"
 #include "../utils/in_range.h"
+#include "../utils/char_class.h"
+#include "../utils/record_range.h"
+#include "../utils/thread_pool.h"
 
-#include <map>
+#include <array>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <optional>
 #include <algorithm>
-#include <sstream>
+#include <functional>
+#include <charconv>
+#include <bit>
 #include <fstream>
+#include <sstream>
+#include <cstdint>
 #include <cassert>
-#include <functional>
 
 namespace
 {
-	using Passport = std::map<std::string, std::string>;
 	using utils::open_puzzle_input;
 	using utils::open_testcase_input;
-	
-	static const std::vector<std::string> REQUIRED_TAGS_P1 {
-		"byr",
-		"iyr",
-		"eyr",
-		"hgt",
-		"hcl",
-		"ecl",
-		"pid"
+
+	enum Field : uint8_t
+	{
+		BYR,
+		IYR,
+		EYR,
+		HGT,
+		HCL,
+		ECL,
+		PID,
+		CID,
+		NUM_FIELDS
 	};
 
-	bool verify_passport(const Passport& passport, const std::vector<std::string>& required_tags)
+	constexpr std::array<std::string_view, NUM_FIELDS> FIELD_NAMES{ "byr", "iyr", "eyr", "hgt", "hcl", "ecl", "pid", "cid" };
+
+	// Gives each of the field names a different slot, so finding a field is one lookup and one compare.
+	// Found by trying small multipliers until all eight came out different.
+	constexpr std::size_t field_name_hash(std::string_view name)
 	{
-		return std::all_of(begin(required_tags), end(required_tags),
-			[&passport](const std::string& tag) {return passport.find(tag) != end(passport); });
+		const auto first = static_cast<unsigned char>(name[0]);
+		const auto second = static_cast<unsigned char>(name[1]);
+		return ((3u * first + 2u * second) >> 1) % NUM_FIELDS;
 	}
 
-	int solve_p1_generic(const std::vector<Passport>& passports, const std::vector<std::string>& required_tags)
+	constexpr std::array<Field, NUM_FIELDS> make_fields_by_hash()
 	{
-		return std::count_if(begin(passports), end(passports),
-			[&required_tags](const Passport& pp) {return verify_passport(pp, required_tags); });
+		std::array<Field, NUM_FIELDS> result{};
+		for (uint8_t field = 0; field < NUM_FIELDS; ++field)
+		{
+			result[field_name_hash(FIELD_NAMES[field])] = static_cast<Field>(field);
+		}
+		return result;
 	}
 
-	Passport get_passport_from_string(std::string input)
+	constexpr std::array<Field, NUM_FIELDS> FIELDS_BY_HASH = make_fields_by_hash();
+
+	constexpr bool is_perfect_hash()
 	{
-		std::istringstream iss{ std::move(input) };
-		auto get_entry = [](const std::string& field)
-		{
-			return Passport::value_type(field.substr(0,3),field.substr(4));
-		};
-		
-		Passport result;
-		for (auto it = std::istream_iterator<std::string>(iss); it != std::istream_iterator<std::string>(); ++it)
+		for (uint8_t field = 0; field < NUM_FIELDS; ++field)
 		{
-			auto field = get_entry(*it);
-			assert(!result.contains(field.first));
-			result.insert(std::move(field));
+			if (FIELDS_BY_HASH[field_name_hash(FIELD_NAMES[field])] != field) return false;
 		}
-		return result;
+		return true;
 	}
 
-	std::vector<Passport> get_passports(std::istream& input)
+	static_assert(is_perfect_hash());
+
+	std::optional<Field> to_field(std::string_view name)
 	{
-		std::vector<Passport> result;
-		while (!input.eof())
+		if (name.size() != 3u) return std::nullopt;
+		const Field field = FIELDS_BY_HASH[field_name_hash(name)];
+		if (FIELD_NAMES[field] != name) return std::nullopt;
+		return field;
+	}
+
+	constexpr uint8_t field_bit(Field field)
+	{
+		return static_cast<uint8_t>(1u << field);
+	}
+
+	constexpr uint8_t REQUIRED_FIELDS = static_cast<uint8_t>(((1u << NUM_FIELDS) - 1) & ~field_bit(CID));
+
+	// The values point into the input, which must outlive the passport.
+	struct Passport
+	{
+		std::array<std::string_view, NUM_FIELDS> fields;
+		uint8_t present = 0;
+	};
+
+	bool verify_passport(const Passport& passport)
+	{
+		return (passport.present & REQUIRED_FIELDS) == REQUIRED_FIELDS;
+	}
+
+	// Fields look like "ecl:gry", separated by any whitespace.
+	Passport get_passport_from_string(std::string_view input)
+	{
+		Passport result;
+		while (true)
 		{
-			std::ostringstream oss;
-			std::size_t line_size = 1;
-			while(line_size != 0)
+			const std::size_t field_start = utils::find_first_not_in(input, utils::space_chars);
+			if (field_start == std::string_view::npos)
+			{
+				break;
+			}
+			input.remove_prefix(field_start);
+			const std::size_t field_size = std::min(input.find_first_of(" \t\r\n"), input.size());
+			const std::string_view entry = input.substr(0, field_size);
+			input.remove_prefix(field_size);
+
+			// Fields we don't know about are ignored, as they don't make a passport invalid.
+			// That includes longer names which start with a known one, like "byrx".
+			if (entry.size() < 4u || entry[3] != ':')
+			{
+				continue;
+			}
+			const auto field = to_field(entry.substr(0, 3));
+			if (!field.has_value())
 			{
-				std::string line;
-				std::getline(input, line);
-				line_size = line.size();
-				oss << std::move(line) << ' ';
+				continue;
 			}
-			result.push_back(get_passport_from_string(oss.str()));
+			assert((result.present & field_bit(*field)) == 0);
+			result.fields[*field] = entry.substr(4);
+			result.present |= field_bit(*field);
 		}
 		return result;
 	}
 
+	// Passports are separated by blank lines. They're shared out between threads a chunk of records at a time.
+	template <typename Check>
+	int count_valid_passports(std::string_view text, Check check)
+	{
+		const std::vector<std::string_view> chunks = utils::split_records_into_chunks(text, 4 * (utils::default_thread_pool().size() + 1));
+		return utils::parallel_reduce(chunks, 0, std::plus<int>{}, [&check](std::string_view chunk)
+		{
+			const utils::record_range records{ chunk };
+			return static_cast<int>(std::count_if(records.begin(), records.end(), [&check](std::string_view record)
+			{
+				return check(get_passport_from_string(record));
+			}));
+		});
+	}
+
 	ResultType solve_p1(std::istream& input)
 	{
-		return solve_p1_generic(get_passports(input), REQUIRED_TAGS_P1);
+		const std::string text = utils::read_whole_stream(input);
+		return count_valid_passports(text, verify_passport);
 	}
 }
 
@@ -88,6 +160,33 @@ ResultType day_four_p1_testcase_a()
 	return solve_p1(input);
 }
 
+ResultType day_four_p1_testcase_unknown_fields()
+{
+	std::istringstream input{
+		"ecl:gry pid:860033327 eyr:2020 hcl:#fffffd xyz:1\n"
+		"byr:1937 iyr:2017 cid:147 hgt:183cm\n"
+		"\n"
+		"abc:def hcl:#cfa07d eyr:2025 pid:166559648\n"
+		"iyr:2011 ecl:brn hgt:59in byr:1931\n"
+		"\n"
+		"ecl:gry pid:860033327 eyr:2020 hcl:#fffffd zzz:0\n"
+		"iyr:2017 hgt:183cm\n"
+	};
+	return solve_p1(input);
+}
+
+ResultType day_four_p1_testcase_long_names()
+{
+	std::istringstream input{
+		"ecl:gry pid:860033327 eyr:2020 hcl:#fffffd abcd:1\n"
+		"byr:1937 iyr:2017 cid:147 hgt:183cm\n"
+		"\n"
+		"ecl:gry pid:860033327 eyr:2020 hcl:#fffffd\n"
+		"byrx:1937 iyr:2017 cid:147 hgt:183cm\n"
+	};
+	return solve_p1(input);
+}
+
 ResultType advent_four_p1()
 {
 	std::ifstream input = open_puzzle_input(4);
@@ -96,34 +195,35 @@ ResultType advent_four_p1()
 
 namespace
 {
-	bool verify_text_number(const std::string& field, int min, int max)
+	bool verify_text_number(std::string_view field, int min, int max)
 	{
-		if (!std::all_of(begin(field), end(field), [](char c) {return std::isdigit(c); })) return false;
-		const int val = std::stoi(field);
+		if (field.empty() || !utils::all_in(field, utils::digit_chars)) return false;
+		int val = 0;
+		const std::from_chars_result parsed = std::from_chars(field.data(), field.data() + field.size(), val);
+		if (parsed.ec != std::errc{}) return false;
 		return utils::in_range(val, min, max);
 	}
 
-	bool verify_byr(const std::string& field)
+	bool verify_byr(std::string_view field)
 	{
 		return verify_text_number(field, 1920, 2002);
 	}
 
-	bool verify_iyr(const std::string& field)
+	bool verify_iyr(std::string_view field)
 	{
 		return verify_text_number(field, 2010, 2020);
 	}
 
-	bool verify_eyr(const std::string& field)
+	bool verify_eyr(std::string_view field)
 	{
 		return verify_text_number(field, 2020, 2030);
 	}
 
-	bool verify_hgt(const std::string& field)
+	bool verify_hgt(std::string_view field)
 	{
-		const auto split_point = field.find_first_of("ic");
-		if (split_point >= field.size()) return false;
-		const std::string number = field.substr(0, split_point);
-		const std::string suffix = field.substr(split_point);
+		if (field.size() < 2u) return false;
+		const std::string_view number = field.substr(0, field.size() - 2);
+		const std::string_view suffix = field.substr(field.size() - 2);
 		if (suffix == "cm")
 		{
 			return verify_text_number(number, 150, 193);
@@ -135,66 +235,57 @@ namespace
 		return false;
 	}
 
-	bool verify_hcl(const std::string& field)
+	bool verify_hcl(std::string_view field)
 	{
 		if (field.size() != 7u) return false;
-		return field[0] == '#' && std::all_of(begin(field) + 1, end(field), [](char c)
-		{
-			return isdigit(c) || utils::in_range(c, 'a', 'f');
-		});
+		return field[0] == '#' && utils::all_in(field.substr(1), utils::lower_hex_chars);
 	}
 
-	bool verify_ecl(const std::string& field)
+	bool verify_ecl(std::string_view field)
 	{
-		static const std::vector<std::string> allowed_values = {
+		constexpr std::array<std::string_view, 7> allowed_values{
 			"amb", "blu", "brn", "gry", "grn", "hzl", "oth"
 		};
 		return std::find(begin(allowed_values), end(allowed_values), field) != end(allowed_values);
 	}
 
-	bool verify_pid(const std::string& field)
+	bool verify_pid(std::string_view field)
 	{
-		return field.size() == 9u && std::all_of(begin(field), end(field), ::isdigit);
+		return field.size() == 9u && utils::all_in(field, utils::digit_chars);
 	}
 
-	bool verify_cid(const std::string& field)
+	bool verify_cid(std::string_view)
 	{
 		return true;
 	}
 
-	bool verify_field(const Passport::value_type& input)
-	{
-
-		static const std::map<std::string, std::function<bool(const std::string&)>> verify_map{
-			{"byr",verify_byr},
-			{"iyr",verify_iyr},
-			{"eyr",verify_eyr},
-			{"hgt",verify_hgt},
-			{"hcl",verify_hcl},
-			{"ecl",verify_ecl},
-			{"pid",verify_pid},
-			{"cid",verify_cid}
-		};
-
-		auto find_result = verify_map.find(input.first);
-		assert(find_result != end(verify_map));
-		return find_result->second(input.second);
-	}
-
-	bool verify_passport_and_fields(const Passport& passport, const std::vector<std::string>& required_tags)
-	{
-		return verify_passport(passport, required_tags) && std::all_of(begin(passport), end(passport), verify_field);
-	}
+	// In the same order as Field.
+	constexpr std::array<bool(*)(std::string_view), NUM_FIELDS> VERIFIERS{
+		verify_byr,
+		verify_iyr,
+		verify_eyr,
+		verify_hgt,
+		verify_hcl,
+		verify_ecl,
+		verify_pid,
+		verify_cid
+	};
 
-	int solve_p2_generic(const std::vector<Passport>& passports, const std::vector<std::string>& required_tags)
+	bool verify_passport_and_fields(const Passport& passport)
 	{
-		return std::count_if(begin(passports), end(passports),
-			[&required_tags](const Passport& p) { return verify_passport_and_fields(p, required_tags); });
+		if (!verify_passport(passport)) return false;
+		for (uint8_t remaining = passport.present; remaining != 0; remaining &= remaining - 1)
+		{
+			const auto field = static_cast<Field>(std::countr_zero(remaining));
+			if (!VERIFIERS[field](passport.fields[field])) return false;
+		}
+		return true;
 	}
 
 	ResultType solve_p2(std::istream& input)
 	{
-		return solve_p2_generic(get_passports(input), REQUIRED_TAGS_P1);
+		const std::string text = utils::read_whole_stream(input);
+		return count_valid_passports(text, verify_passport_and_fields);
 	}
 }
 
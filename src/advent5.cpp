@@ -1,72 +1,163 @@
 #include "../advent/advent5.h"
 #include "../utils/advent_utils.h"
-#include "../utils/sorted_vector.h"
+#include "../utils/char_class.h"
+#include "../utils/dense_bitset.h"
 
 #include <string>
-#include <numeric>
+#include <string_view>
+#include <array>
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <bit>
+#include <cstdint>
 #include <cassert>
 
 namespace
 {
 	using FileIt = std::istream_iterator<std::string>;
 	using utils::open_puzzle_input;
-	using utils::sorted_vector;
 
 	constexpr char FORWARD = 'F';
 	constexpr char BACKWARD = 'B';
 	constexpr char LEFT = 'L';
 	constexpr char RIGHT = 'R';
 
-	template <typename InputIt>
-	int partition(InputIt pass_start, InputIt pass_finish, int low_end, int top_end, char go_low, char go_high)
+	// Passes up to this long are decoded with SSE2, and longer ones a letter at a time.
+	constexpr std::size_t MAX_SIMD_PASS_LENGTH = 16;
+
+	// The seat number has to fit in an int, and read_seats keeps a bit for every possible seat,
+	// so this many digits already takes 128MB.
+	constexpr int MAX_SEAT_DIGITS = 30;
+
+	// Each letter is a binary digit, with the row digits before the column digits, so the seat
+	// number is just the whole pass read as binary.
+	// B and R are the only ones of the four letters with bit 2 clear, so that bit alone gives the digit.
+	constexpr uint32_t seat_digit(char c)
 	{
-		if (pass_start == pass_finish)
-		{
-			assert(low_end == top_end || low_end == (top_end -1));
-			return low_end;
-		}
-		const char section = *pass_start;
-		assert(section == go_low || section == go_high);
+		return ((static_cast<uint32_t>(static_cast<unsigned char>(c)) >> 2) & 1) ^ 1;
+	}
 
-		auto recurse = [&](int new_lower, int new_upper)
-		{
-			return partition(pass_start + 1, pass_finish, new_lower, new_upper, go_low, go_high);
-		};
+	static_assert(seat_digit(FORWARD) == 0 && seat_digit(LEFT) == 0);
+	static_assert(seat_digit(BACKWARD) == 1 && seat_digit(RIGHT) == 1);
+
+	constexpr uint32_t reverse_bits16(uint32_t x)
+	{
+		x = ((x & 0x5555) << 1) | ((x >> 1) & 0x5555);
+		x = ((x & 0x3333) << 2) | ((x >> 2) & 0x3333);
+		x = ((x & 0x0F0F) << 4) | ((x >> 4) & 0x0F0F);
+		x = ((x & 0x00FF) << 8) | ((x >> 8) & 0x00FF);
+		return x;
+	}
 
-		const int midpoint = low_end + ((top_end - low_end) / 2);
-		if (section == go_low)
+	static_assert(reverse_bits16(0x0001) == 0x8000 && reverse_bits16(0x00F0) == 0x0F00);
+
+	int decode_seat_by_letter(std::string_view pass)
+	{
+		uint32_t result = 0;
+		for (char c : pass)
 		{
-			return recurse(low_end, midpoint);
+			result = (result << 1) | seat_digit(c);
 		}
-		else if (section == go_high)
+		return static_cast<int>(result);
+	}
+
+	// With SSE2 all the digits come out of one movemask, with digit i in bit i. The first letter
+	// is the most significant digit, so the bits are reversed to finish.
+	int decode_seat(std::string_view pass)
+	{
+		assert(pass.size() <= static_cast<std::size_t>(MAX_SEAT_DIGITS));
+		assert(utils::all_in(pass, utils::char_class::of("FBLR")));
+#if UTILS_CHAR_CLASS_SSE2
+		if (pass.size() <= MAX_SIMD_PASS_LENGTH)
 		{
-			return recurse(midpoint, top_end);
+			alignas(16) std::array<char, MAX_SIMD_PASS_LENGTH> padded{};
+			std::copy(begin(pass), end(pass), begin(padded));
+			const __m128i letters = _mm_load_si128(reinterpret_cast<const __m128i*>(padded.data()));
+			// Shifting each 16-bit lane left by 5 moves bit 2 of both its bytes to bit 7, where movemask reads it.
+			const auto bit_2_set = static_cast<uint32_t>(_mm_movemask_epi8(_mm_slli_epi16(letters, 5)));
+			const uint32_t digits = ~bit_2_set & ((uint32_t{ 1 } << pass.size()) - 1);
+			return static_cast<int>(reverse_bits16(digits) >> (MAX_SIMD_PASS_LENGTH - pass.size()));
 		}
-		assert(false);
-		return -1;
+#endif
+		return decode_seat_by_letter(pass);
 	}
 
-	template <typename InputIt>
-	int partition(InputIt start, InputIt finish, int max_val, char go_low, char go_high)
+	int get_seat_number_generic(std::string_view id, int row_digits, int col_digits)
 	{
-		return partition(start, finish, 0, max_val, go_low, go_high);
+		assert(static_cast<int>(id.size()) == (row_digits + col_digits));
+		assert(utils::all_in(id.substr(0, row_digits), utils::char_class::of("FB")));
+		assert(utils::all_in(id.substr(row_digits), utils::char_class::of("LR")));
+		return decode_seat(id);
 	}
 
-	int get_seat_number_generic(const std::string& id, int row_digits, int col_digits)
+	int get_seat_number_p1(std::string_view id)
 	{
-		assert(static_cast<int>(id.size()) == (row_digits + col_digits));
-		const int num_rows = 1 << row_digits;
-		const int num_cols = 1 << col_digits;
+		return get_seat_number_generic(id, 7, 3);
+	}
 
-		const auto split_point = begin(id) + row_digits;
-		const int row_number = partition(begin(id), split_point, num_rows, FORWARD, BACKWARD);
-		const int col_number = partition(split_point, end(id), num_cols, LEFT, RIGHT);
-		return row_number * num_cols + col_number;
+	// One bit per seat, set if someone has a pass for it.
+	utils::dynamic_bitset read_seats(std::istream& input, int row_digits, int col_digits)
+	{
+		assert(row_digits >= 0 && col_digits >= 0 && row_digits + col_digits <= MAX_SEAT_DIGITS);
+		utils::dynamic_bitset result(std::size_t{ 1 } << (row_digits + col_digits));
+		std::for_each(FileIt{ input }, FileIt{}, [&](const std::string& s)
+		{
+			result.set(static_cast<std::size_t>(get_seat_number_generic(s, row_digits, col_digits)));
+		});
+		return result;
 	}
 
-	int get_seat_number_p1(const std::string& id)
+	int highest_seat(const utils::dynamic_bitset& seats)
 	{
-		return get_seat_number_generic(id, 7, 3);
+		const auto words = seats.words();
+		for (std::size_t i = words.size(); i > 0; --i)
+		{
+			if (words[i - 1] != 0)
+			{
+				return static_cast<int>(i * 64 - 1 - std::countl_zero(words[i - 1]));
+			}
+		}
+		assert(false);
+		return -1;
+	}
+
+	// The empty seat with both neighbours taken. Each word is compared with itself shifted
+	// one seat either way, with the neighbouring words' end bits carried across.
+	int find_gap(const utils::dynamic_bitset& seats)
+	{
+		const auto words = seats.words();
+		for (std::size_t i = 0; i < words.size(); ++i)
+		{
+			const uint64_t taken = words[i];
+			const uint64_t seat_before_taken = (taken << 1) | (i > 0 ? words[i - 1] >> 63 : 0);
+			const uint64_t seat_after_taken = (taken >> 1) | (i + 1 < words.size() ? words[i + 1] << 63 : 0);
+			const uint64_t gaps = ~taken & seat_before_taken & seat_after_taken;
+			if (gaps != 0)
+			{
+				assert(std::has_single_bit(gaps));
+				return static_cast<int>(i * 64 + std::countr_zero(gaps));
+			}
+		}
+		assert(false);
+		return -1;
+	}
+
+	// Passes for every seat in [first, last] apart from the one missed out.
+	std::istringstream make_testcase_passes(int first, int last, int missing)
+	{
+		std::ostringstream passes;
+		for (int seat = first; seat <= last; ++seat)
+		{
+			if (seat == missing) continue;
+			for (int digit = 9; digit >= 0; --digit)
+			{
+				const bool one = ((seat >> digit) & 1) != 0;
+				passes << (digit >= 3 ? (one ? BACKWARD : FORWARD) : (one ? RIGHT : LEFT));
+			}
+			passes << '\n';
+		}
+		return std::istringstream{ passes.str() };
 	}
 }
 
@@ -90,35 +181,32 @@ ResultType day_five_testcase_d()
 	return get_seat_number_p1("BBFFBBFRLL");
 }
 
+// Too long for one SSE2 register.
+ResultType day_five_testcase_long_pass()
+{
+	return get_seat_number_generic("BFFFFFFFFFFFFFFFFFFFLR", 20, 2);
+}
+
+ResultType day_five_testcase_highest()
+{
+	std::istringstream input = make_testcase_passes(40, 130, 64);
+	return highest_seat(read_seats(input, 7, 3));
+}
+
+ResultType day_five_testcase_gap()
+{
+	std::istringstream input = make_testcase_passes(40, 130, 64);
+	return find_gap(read_seats(input, 7, 3));
+}
 
 ResultType advent_five_p1()
 {
 	std::ifstream input = open_puzzle_input(5);
-	return std::transform_reduce(FileIt{ input }, FileIt{},
-		-1, [](int l, int r) {return std::max(l, r); }, get_seat_number_p1);
+	return highest_seat(read_seats(input, 7, 3));
 }
 
 ResultType advent_five_p2()
 {
-	const sorted_vector<int> ids = []()
-	{
-		sorted_vector<int> result;
-		std::ifstream input = open_puzzle_input(5);
-		std::for_each(FileIt{ input }, FileIt{}, [&result](const std::string& s) {result.insert(get_seat_number_p1(s)); });
-		return result;
-	}();
-	for (std::size_t i = 0; i < (ids.size() - 1); ++i)
-	{
-		const auto this_one = ids[i];
-		const auto next_one = ids[i + 1];
-		const auto difference = next_one - this_one;
-		if (difference == 2)
-		{
-			return this_one + 1;
-		}
-		assert(difference == 1);
-	}
-	assert(false);
-	return "!ERROR!";
-
+	std::ifstream input = open_puzzle_input(5);
+	return find_gap(read_seats(input, 7, 3));
 }
@@ -1,89 +1,103 @@
 #include "../advent/advent6.h"
 #include "../utils/advent_utils.h"
-#include "../utils/istream_line_iterator.h"
+#include "../utils/record_range.h"
+#include "../utils/thread_pool.h"
+#include "../utils/dense_bitset.h"
 
 #include <vector>
 #include <string>
-#include <numeric>
-#include <algorithm>
+#include <string_view>
+#include <sstream>
+#include <functional>
+#include <cassert>
 
 namespace
 {
 	using utils::open_testcase_input;
 	using utils::open_puzzle_input;
 
-	class QuestionairreSolver
+	// Answers are the letters FIRST_ANSWER onwards, one bit each. The puzzle only uses 'a' to 'z',
+	// which fits in one word, but any range of characters works with a wider set.
+	template <char FIRST_ANSWER, std::size_t NUM_ANSWERS>
+	struct Alphabet
 	{
-		std::string group_answers;
-		bool addidative = true;
+		using Answers = utils::dense_bitset<NUM_ANSWERS>;
 
-		int solve_addidative(const std::string& str)
+		static Answers to_answers(std::string_view str)
 		{
-			std::string result;
-			std::set_union(begin(group_answers), end(group_answers), begin(str), end(str), std::back_inserter(result));
-			group_answers = std::move(result);
-			return 0;
-		}
-
-		int solve_subtractive(const std::string& str)
-		{
-			std::string result;
-			std::set_intersection(begin(group_answers), end(group_answers), begin(str), end(str), std::back_inserter(result));
-			group_answers = std::move(result);
-			return 0;
-		}
-
-		void reset()
-		{
-			group_answers = addidative ? "" : "abcdefghijklmnopqrstuvwxyz";
-		}
-
-	public:
-		void set_subtractive()
-		{
-			addidative = false;
-			reset();
-			
-		}
-		int add_line(std::string str)
-		{
-			if (str.empty())
+			Answers result;
+			for (char c : str)
 			{
-				const int result = static_cast<int>(group_answers.size());
-				reset();
-				return result;
+				assert(c >= FIRST_ANSWER && static_cast<std::size_t>(c - FIRST_ANSWER) < NUM_ANSWERS);
+				result.set(static_cast<std::size_t>(c - FIRST_ANSWER));
 			}
-
-			std::sort(begin(str), end(str));
-			return addidative ? solve_addidative(str) : solve_subtractive(str);
+			return result;
 		}
 	};
 
-	int solve_generic(std::istream& file, bool addidative)
+	using LowerCase = Alphabet<'a', 26>;
+
+	// Questions anyone in a group said yes to, and questions everyone said yes to, summed over groups.
+	struct AnswerCounts
+	{
+		int anyone = 0;
+		int everyone = 0;
+	};
+
+	AnswerCounts operator+(const AnswerCounts& left, const AnswerCounts& right)
+	{
+		return AnswerCounts{ left.anyone + right.anyone, left.everyone + right.everyone };
+	}
+
+	// Each group is a record, with one line per person.
+	template <typename Alphabet>
+	AnswerCounts count_group_answers(std::string_view group)
 	{
-		using StreamIt = utils::istream_line_iterator;
-		QuestionairreSolver solver;
-		if (!addidative)
+		using Answers = typename Alphabet::Answers;
+		Answers anyone;
+		Answers everyone = Answers::all();
+		for (std::string_view person : utils::line_range{ group })
 		{
-			solver.set_subtractive();
+			const Answers answers = Alphabet::to_answers(person);
+			anyone |= answers;
+			everyone &= answers;
 		}
-		auto process_line = [&solver](std::string s)
+		return AnswerCounts{ static_cast<int>(anyone.count()), static_cast<int>(everyone.count()) };
+	}
+
+	// Both parts come from the same pass.
+	template <typename Alphabet = LowerCase>
+	AnswerCounts solve_generic(std::istream& file)
+	{
+		const std::string text = utils::read_whole_stream(file);
+		const std::vector<std::string_view> chunks = utils::split_records_into_chunks(text, 4 * (utils::default_thread_pool().size() + 1));
+		return utils::parallel_reduce(chunks, AnswerCounts{}, std::plus<AnswerCounts>{}, [](std::string_view chunk)
 		{
-			return solver.add_line(std::move(s));
-		};
-		auto combine_results = [](int a, int b) { return a + b; };
-		const int result = std::transform_reduce(StreamIt(file), StreamIt(), 0, combine_results, process_line);
-		return result + solver.add_line("");
+			AnswerCounts result;
+			for (std::string_view group : utils::record_range{ chunk })
+			{
+				result = result + count_group_answers<Alphabet>(group);
+			}
+			return result;
+		});
 	}
 
 	int solve_p1_generic(std::istream& file)
 	{
-		return solve_generic(file, true);
+		return solve_generic(file).anyone;
 	}
 
 	int solve_p2_generic(std::istream& file)
 	{
-		return solve_generic(file, false);
+		return solve_generic(file).everyone;
+	}
+
+	// Every printable character, which needs two words of bits.
+	std::string solve_wide_testcase()
+	{
+		std::istringstream input{ "aA\nAb~\n\n!z\nz!\n" };
+		const AnswerCounts result = solve_generic<Alphabet<'!', '~' - '!' + 1>>(input);
+		return std::to_string(result.anyone) + ',' + std::to_string(result.everyone);
 	}
 
 	std::ifstream get_testcase_input()
@@ -98,6 +112,11 @@ ResultType day_six_testcase_a()
 	return solve_p1_generic(input);
 }
 
+ResultType day_six_testcase_wide_alphabet()
+{
+	return solve_wide_testcase();
+}
+
 ResultType advent_six_p1()
 {
 	std::ifstream input = open_puzzle_input(6);
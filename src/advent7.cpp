@@ -1,59 +1,41 @@
 #include "../advent/advent7.h"
 #include "../utils/advent_utils.h"
 #include "../utils/istream_line_iterator.h"
-#include "../utils/binary_find.h"
+#include "../utils/interner.h"
+#include "../utils/csr_graph.h"
 
 #include <fstream>
 #include <vector>
 #include <string>
 #include <algorithm>
 #include <sstream>
-#include <numeric>
+#include <cstdint>
 
 namespace
 {
-	using Bag = std::ptrdiff_t;
+	using Bag = std::size_t;
 	using namespace utils;
 
-	Bag to_bag(const std::string& str)
+	Bag to_bag(interner& bag_names, std::string_view str)
 	{
-		static std::vector<std::string> bag_list;
-		const auto loc = std::find(begin(bag_list), end(bag_list), str);
-		if (loc != end(bag_list))
-		{
-			return std::distance(begin(bag_list), loc);
-		}
-		else
-		{
-			const int result = static_cast<Bag>(bag_list.size());
-			bag_list.push_back(str);
-			return result;
-		}
+		return static_cast<Bag>(bag_names.intern(str));
 	}
 	
+	// An amount of 0 is "no other bags".
 	struct PermittedBag
 	{
 		int amount = 0;
-		Bag bag = -1;
-	};
-	enum class CanHoldReference : char
-	{
-		no,
-		yes,
-		unknown
+		Bag bag = 0;
 	};
 	struct Rule
 	{
 		std::vector<PermittedBag> permitted_bags;
-		Bag bag;
-		mutable CanHoldReference can_hold = CanHoldReference::unknown;
-		mutable int extra_bags_required = -1;
-		bool operator<(const Rule& other) const { return bag < other.bag; }
+		Bag bag = 0;
 	};
 
 	using Ruleset = std::vector<Rule>;
 
-	Bag extract_bag(std::istream& input, const std::string& expected_end)
+	Bag extract_bag(std::istream& input, const std::string& expected_end, interner& bag_names)
 	{
 		std::ostringstream bag_id;
 		while (!input.eof())
@@ -63,7 +45,7 @@ namespace
 			if (next_word == "bag" || next_word == "bags" || next_word.empty())
 			{
 				assert(next_word == expected_end);
-				return to_bag(bag_id.str());
+				return to_bag(bag_names, bag_id.str());
 			}
 			else
 			{
@@ -71,16 +53,16 @@ namespace
 			}
 		}
 		assert(false);
-		return -1;
+		return 0;
 	}
 
-	Bag extract_bag(std::string input, const std::string& expected_end)
+	Bag extract_bag(std::string input, const std::string& expected_end, interner& bag_names)
 	{
 		std::istringstream iss{ std::string{input} };
-		return extract_bag(iss, expected_end);
+		return extract_bag(iss, expected_end, bag_names);
 	}
 
-	PermittedBag extract_permitted_bags(std::string str)
+	PermittedBag extract_permitted_bags(std::string str, interner& bag_names)
 	{
 		PermittedBag result;
 		if (str == " no other bags")
@@ -89,125 +71,116 @@ namespace
 		}
 		std::istringstream input{ std::move(str) };
 		input >> result.amount;
-		result.bag = extract_bag(input,result.amount == 1 ? "bag" : "bags");
+		result.bag = extract_bag(input,result.amount == 1 ? "bag" : "bags", bag_names);
 		return result;
 	}
 
-	Rule parse_rule(std::string rulestring)
+	Rule parse_rule(std::string rulestring, interner& bag_names)
 	{
 		assert(rulestring.back() == '.');
 		rulestring.pop_back();
 		std::istringstream input{ std::move(rulestring) };
 
 		Rule result;
-		result.bag = extract_bag(input, "bags");
+		result.bag = extract_bag(input, "bags", bag_names);
 		std::string dummy;
 		input >> dummy;
 		assert(dummy == "contain");
 		
 		std::transform(istream_line_iterator(input, ','), istream_line_iterator(),
-			std::back_inserter(result.permitted_bags), extract_permitted_bags);
+			std::back_inserter(result.permitted_bags),
+			[&bag_names](std::string str) {return extract_permitted_bags(std::move(str), bag_names); });
 
 		return result;
 	}
 
-	Ruleset parse_rules(std::istream& input)
+	Ruleset parse_rules(std::istream& input, interner& bag_names)
 	{
 		Ruleset result;
 		std::transform(istream_line_iterator(input), istream_line_iterator(),
-			std::back_inserter(result), parse_rule);
-		std::sort(begin(result), end(result));
+			std::back_inserter(result),
+			[&bag_names](std::string rulestring) {return parse_rule(std::move(rulestring), bag_names); });
 		return result;
 	}
 
-	auto get_rule_iterator(const Ruleset& rules, Bag target)
-	{
-		Rule reference;
-		reference.bag = target;
-		return binary_find(begin(rules), end(rules), reference);
-	}
-
-	bool can_bag_contain(Bag container, const Ruleset& rules, Bag target)
+	// The rules as a graph, with an edge from each bag to each kind of bag it holds, weighted by how many.
+	// The reversed graph leads from each bag to the bags that can hold it.
+	class BagGraph
 	{
-		if (container == target) return false;
-
-		const auto rule_it = get_rule_iterator(rules, container);
-		if (rule_it == end(rules)) return false;
-		switch (rule_it->can_hold)
+		csr_graph<int> m_contents;
+		csr_graph<int> m_containers;
+		// How many bags are inside one of each bag, all the way down.
+		std::vector<int64_t> m_total_contents;
+	public:
+		BagGraph(const Ruleset& rules, std::size_t num_bags)
 		{
-		case CanHoldReference::yes:
-			return true;
-		case CanHoldReference::no:
-			return false;
-		default:
-			break;
-		}
+			std::vector<csr_graph<int>::input_edge> edges;
+			for (const Rule& rule : rules)
+			{
+				for (const PermittedBag& pb : rule.permitted_bags)
+				{
+					if (pb.amount > 0)
+					{
+						edges.push_back(csr_graph<int>::input_edge{ rule.bag, pb.bag, pb.amount });
+					}
+				}
+			}
+			m_contents = csr_graph<int>{ num_bags, edges };
+			m_containers = m_contents.reversed();
 
-		const auto& allowed_bags = rule_it->permitted_bags;
-		if (allowed_bags.size() == 0u)
-		{
-			rule_it->can_hold = CanHoldReference::no;
-			return false;
+			// Each bag comes before the bags it holds, so going backwards does the contents of a bag first.
+			const std::vector<std::size_t> order = m_contents.topological_order();
+			m_total_contents.assign(num_bags, 0);
+			for (auto it = order.rbegin(); it != order.rend(); ++it)
+			{
+				int64_t total = 0;
+				for (const auto& e : m_contents.out_edges(*it))
+				{
+					total += e.weight * (1 + m_total_contents[e.target]);
+				}
+				m_total_contents[*it] = total;
+			}
 		}
 
-		const auto find_result = std::find_if(begin(allowed_bags), end(allowed_bags),
-			[target](const PermittedBag& pb) {return pb.bag == target; });
-
-		if (find_result != end(allowed_bags))
+		// How many kinds of bag could end up holding this one.
+		int count_containers(Bag bag) const
 		{
-			rule_it->can_hold = CanHoldReference::yes;
-			return true;
+			return static_cast<int>(m_containers.reachable_from(bag).count());
 		}
 
-		const bool result = std::any_of(begin(allowed_bags), end(allowed_bags),
-			[target, &rules](const PermittedBag& pb) {return can_bag_contain(pb.bag, rules, target); });
-
-		rule_it->can_hold = result ? CanHoldReference::yes : CanHoldReference::no;
-		return result;
-	}
-
-	int solve_p1_generic(const Ruleset& rules, Bag bag)
-	{
-		return std::count_if(begin(rules), end(rules),
-			[bag,&rules](const Rule& r)
+		int64_t count_contents(Bag bag) const
 		{
-			return can_bag_contain(r.bag, rules, bag);
-		});
-	}
+			return m_total_contents[bag];
+		}
+	};
 
 	int solve_p1(std::istream& input)
 	{
-		const Ruleset rules = parse_rules(input);
-		return solve_p1_generic(rules, extract_bag("shiny gold bag", "bag"));
+		interner bag_names;
+		const Ruleset rules = parse_rules(input, bag_names);
+		const Bag target = extract_bag("shiny gold bag", "bag", bag_names);
+		const BagGraph graph{ rules, bag_names.size() };
+		return graph.count_containers(target);
 	}
 
-	int solve_p2_generic(const Ruleset& rules, Bag bag)
+	int64_t solve_p2(std::istream& input)
 	{
-		const auto rule_it = get_rule_iterator(rules, bag);
-		if (rule_it == end(rules)) return 0;
-
-		if (rule_it->extra_bags_required != -1)
-		{
-			return rule_it->extra_bags_required;
-		}
-
-		const auto& contained_bags = rule_it->permitted_bags;
-		auto get_all_bags = [&rules](int prev, const PermittedBag& pb)
-		{
-			const int per_bag = solve_p2_generic(rules, pb.bag);
-			return prev + pb.amount * (1 + per_bag);
-		};
-
-		const int result = std::accumulate(begin(contained_bags), end(contained_bags),
-			0, get_all_bags);
-		rule_it->extra_bags_required = result;
-		return result;
+		interner bag_names;
+		const Ruleset rules = parse_rules(input, bag_names);
+		const Bag target = extract_bag("shiny gold bag", "bag", bag_names);
+		const BagGraph graph{ rules, bag_names.size() };
+		return graph.count_contents(target);
 	}
 
-	int solve_p2(std::istream& input)
+	// One graph, asked about bags other than shiny gold.
+	std::string solve_queries(std::istream& input)
 	{
-		const Ruleset rules = parse_rules(input);
-		return solve_p2_generic(rules, extract_bag("shiny gold bag", "bag"));
+		interner bag_names;
+		const Ruleset rules = parse_rules(input, bag_names);
+		const Bag faded_blue = extract_bag("faded blue bag", "bag", bag_names);
+		const Bag muted_yellow = extract_bag("muted yellow bag", "bag", bag_names);
+		const BagGraph graph{ rules, bag_names.size() };
+		return std::to_string(graph.count_containers(faded_blue)) + ',' + std::to_string(graph.count_contents(muted_yellow));
 	}
 }
 
@@ -217,6 +190,12 @@ ResultType day_seven_testcase_a()
 	return solve_p1(input);
 }
 
+ResultType day_seven_testcase_queries()
+{
+	std::ifstream input = open_testcase_input(7, 'a');
+	return solve_queries(input);
+}
+
 ResultType advent_seven_p1()
 {
 	auto input = open_puzzle_input(7);
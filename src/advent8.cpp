@@ -2,6 +2,7 @@
 #include "../utils/advent_utils.h"
 #include "../utils/istream_line_iterator.h"
 #include "../utils/int_range.h"
+#include "../utils/thread_pool.h"
 
 #include <sstream>
 #include <vector>
@@ -10,7 +11,6 @@
 #include <set>
 #include <functional>
 #include <numeric>
-#include <execution>
 
 namespace
 {
@@ -149,8 +149,7 @@ namespace
 	{
 		const Program program = extract_program(input);
 		int_range range{ program.size() };
-		const auto result = std::transform_reduce(std::execution::parallel_unsequenced_policy{},
-			begin(range), end(range),
+		const auto result = utils::parallel_reduce(range,
 			HandheldConsoleCPU{}, find_one_that_terminated, [&program](std::size_t i)
 		{
 			return flip_instruction_and_run(program, i);
@@ -0,0 +1,867 @@
+#include "../advent/benchmarks.h"
+#include "../utils/sorted_vector.h"
+#include "../utils/frozen_sorted_vector.h"
+#include "../utils/ring_buffer.h"
+#include "../utils/concurrent_ring_buffer.h"
+#include "../utils/interner.h"
+#include "../utils/int_range.h"
+#include "../utils/thread_pool.h"
+#include "../utils/memo.h"
+#include "../utils/isqrt.h"
+#include "../utils/char_class.h"
+#include "../utils/trim_string.h"
+#include "../utils/k_sum.h"
+#include "../utils/char_count_batch.h"
+#include "../utils/record_range.h"
+
+#include <random>
+#include <chrono>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <string>
+#include <numeric>
+#include <execution>
+#include <functional>
+#include <algorithm>
+#include <cctype>
+#include <future>
+#include <atomic>
+#include <mutex>
+#include <bit>
+#include <cstdint>
+
+namespace
+{
+	constexpr std::size_t NUM_QUERIES = 1'000'000;
+
+	// Raw mt19937 output is the same everywhere, unlike the std distributions.
+	// Keys are drawn from twice the range that gets inserted, so about half the queries miss.
+	utils::sorted_vector<uint32_t> make_data(std::size_t num_elements)
+	{
+		std::mt19937 gen{ 2020 };
+		std::vector<uint32_t> data;
+		data.reserve(num_elements);
+		for (std::size_t i = 0; i < num_elements; ++i)
+		{
+			data.push_back(static_cast<uint32_t>(gen() % (2 * num_elements)));
+		}
+		utils::sorted_vector<uint32_t> result;
+		result.insert(begin(data), end(data));
+		result.make_unique();
+		return result;
+	}
+
+	std::vector<uint32_t> make_queries(std::size_t num_elements)
+	{
+		std::mt19937 gen{ 25 };
+		std::vector<uint32_t> result;
+		result.reserve(NUM_QUERIES);
+		for (std::size_t i = 0; i < NUM_QUERIES; ++i)
+		{
+			result.push_back(static_cast<uint32_t>(gen() % (2 * num_elements)));
+		}
+		return result;
+	}
+
+	// Only the query loop is timed. The number found stops the loop being optimised away,
+	// and should match between containers.
+	template <typename Container>
+	ResultType time_queries(const Container& container, const std::vector<uint32_t>& queries)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		std::size_t num_found = 0;
+		for (uint32_t query : queries)
+		{
+			num_found += container.contains(query) ? 1 : 0;
+		}
+		const auto time_taken = std::chrono::steady_clock::now() - start;
+		const auto ns_per_query = std::chrono::duration_cast<std::chrono::nanoseconds>(time_taken).count() / static_cast<double>(queries.size());
+		return std::to_string(num_found) + " found, " + std::to_string(ns_per_query) + "ns/query";
+	}
+
+	constexpr int64_t NUM_PIPELINE_VALUES = 1'000'000;
+	constexpr std::size_t PIPELINE_CAPACITY = 1024;
+}
+
+ResultType benchmark_sorted_vector_find_generic(std::size_t num_elements)
+{
+	const auto data = make_data(num_elements);
+	return time_queries(data, make_queries(num_elements));
+}
+
+ResultType benchmark_frozen_sorted_vector_find_generic(std::size_t num_elements)
+{
+	const utils::frozen_sorted_vector<uint32_t> data{ make_data(num_elements) };
+	return time_queries(data, make_queries(num_elements));
+}
+
+ResultType benchmark_ring_buffer_against_deque()
+{
+	std::mt19937 gen{ 31 };
+	utils::ring_buffer<int> ring;
+	std::deque<int> reference;
+	for (int i = 0; i < 1'000'000; ++i)
+	{
+		// Push slightly more often than pop, so it wraps around and grows.
+		switch (gen() % 9)
+		{
+		case 0:
+		case 1:
+			ring.push_back(i);
+			reference.push_back(i);
+			break;
+		case 2:
+		case 3:
+			ring.push_front(i);
+			reference.push_front(i);
+			break;
+		case 4:
+		case 5:
+			if (!reference.empty())
+			{
+				ring.pop_back();
+				reference.pop_back();
+			}
+			break;
+		case 6:
+		case 7:
+			if (!reference.empty())
+			{
+				ring.pop_front();
+				reference.pop_front();
+			}
+			break;
+		default:
+			if (!reference.empty())
+			{
+				const std::size_t new_front = gen() % reference.size();
+				ring.rotate(new_front);
+				std::rotate(begin(reference), begin(reference) + new_front, end(reference));
+			}
+			break;
+		}
+		if (ring.size() != reference.size())
+		{
+			return "size mismatch";
+		}
+		if (!reference.empty() && (ring.front() != reference.front() || ring.back() != reference.back()))
+		{
+			return "value mismatch";
+		}
+	}
+	for (std::size_t i = 0; i < reference.size(); ++i)
+	{
+		if (ring[i] != reference[i])
+		{
+			return "value mismatch";
+		}
+	}
+	return "ok";
+}
+
+// One thread pushes 1 to N, and this thread pops and adds them up.
+ResultType benchmark_spsc_ring_buffer_pipeline()
+{
+	utils::spsc_ring_buffer<int64_t> queue{ PIPELINE_CAPACITY };
+	std::thread producer{ [&queue]()
+	{
+		for (int64_t i = 1; i <= NUM_PIPELINE_VALUES; ++i)
+		{
+			queue.push(i);
+		}
+	} };
+	int64_t result = 0;
+	for (int64_t i = 0; i < NUM_PIPELINE_VALUES; ++i)
+	{
+		result += queue.pop();
+	}
+	producer.join();
+	return result;
+}
+
+// Two threads each push half of 1 to N, and two threads pop and add them up.
+ResultType benchmark_mpmc_ring_buffer_pipeline()
+{
+	utils::mpmc_ring_buffer<int64_t> queue{ PIPELINE_CAPACITY };
+	auto produce = [&queue](int64_t first)
+	{
+		for (int64_t i = first; i <= NUM_PIPELINE_VALUES; i += 2)
+		{
+			queue.push(i);
+		}
+	};
+	std::atomic<int64_t> result{ 0 };
+	auto consume = [&queue, &result]()
+	{
+		int64_t sum = 0;
+		for (int64_t i = 0; i < NUM_PIPELINE_VALUES / 2; ++i)
+		{
+			sum += queue.pop();
+		}
+		result += sum;
+	};
+	std::thread producers[] = { std::thread{ produce, 1 }, std::thread{ produce, 2 } };
+	std::thread consumers[] = { std::thread{ consume }, std::thread{ consume } };
+	for (auto& t : producers) t.join();
+	for (auto& t : consumers) t.join();
+	return result.load();
+}
+
+// Four threads intern the same 1000 names in different orders. Every thread must agree on the IDs.
+ResultType benchmark_concurrent_interner()
+{
+	constexpr int NUM_NAMES = 1000;
+	constexpr int NUM_THREADS = 4;
+	std::vector<std::string> names;
+	for (int i = 0; i < NUM_NAMES; ++i)
+	{
+		names.push_back("name" + std::to_string(i));
+	}
+
+	utils::concurrent_interner interner;
+	std::vector<std::vector<utils::concurrent_interner::id_type>> ids(NUM_THREADS);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < NUM_THREADS; ++t)
+	{
+		threads.emplace_back([&names, &interner, &result = ids[t], t]()
+		{
+			result.resize(NUM_NAMES);
+			for (int repeat = 0; repeat < 100; ++repeat)
+			{
+				for (int i = 0; i < NUM_NAMES; ++i)
+				{
+					const int name_idx = (i * (2 * t + 1) + repeat) % NUM_NAMES;
+					result[name_idx] = interner.intern(names[name_idx]);
+				}
+			}
+		});
+	}
+	for (auto& t : threads) t.join();
+
+	for (int i = 0; i < NUM_NAMES; ++i)
+	{
+		for (int t = 1; t < NUM_THREADS; ++t)
+		{
+			if (ids[t][i] != ids[0][i]) return "id mismatch";
+		}
+		if (interner[ids[0][i]] != names[i]) return "name mismatch";
+	}
+	return static_cast<int64_t>(interner.size());
+}
+
+namespace
+{
+	// Enough work per element that splitting the range between threads pays off.
+	int64_t collatz_length(int64_t n)
+	{
+		int64_t result = 0;
+		while (n != 1)
+		{
+			n = (n % 2 == 0) ? n / 2 : 3 * n + 1;
+			++result;
+		}
+		return result;
+	}
+
+	template <typename Policy, typename Transform = int64_t(*)(int64_t)>
+	std::pair<int64_t, double> time_collatz_total(const Policy& policy, const utils::int_range<int64_t>& range, Transform transform = collatz_length)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		const int64_t total = std::transform_reduce(policy, begin(range), end(range), int64_t{ 0 }, std::plus<int64_t>{}, transform);
+		const auto time_taken = std::chrono::steady_clock::now() - start;
+		return std::pair{ total, std::chrono::duration<double, std::milli>(time_taken).count() };
+	}
+
+	// Collects the ids of the threads that call record(). Each thread only takes the lock
+	// the first time it records into a given recorder.
+	class thread_recorder
+	{
+		static inline std::atomic<uint64_t> s_next_generation{ 1 };
+		const uint64_t m_generation = s_next_generation++;
+		std::mutex m_mutex;
+		std::vector<std::thread::id> m_ids;
+	public:
+		void record()
+		{
+			thread_local uint64_t recorded_generation = 0;
+			if (recorded_generation == m_generation)
+			{
+				return;
+			}
+			recorded_generation = m_generation;
+			std::lock_guard lock{ m_mutex };
+			m_ids.push_back(std::this_thread::get_id());
+		}
+
+		std::size_t num_threads()
+		{
+			std::lock_guard lock{ m_mutex };
+			return m_ids.size();
+		}
+	};
+}
+
+// The same transform_reduce over an int_range, sequentially and in parallel.
+// The speedup depends on the number of cores, and on the standard library having a parallel backend,
+// so the number of threads the parallel run used is reported alongside it.
+ResultType benchmark_int_range_parallel_transform_reduce()
+{
+	const utils::int_range<int64_t> range{ 1, 2'000'001 };
+	// The sequential run records its thread too, so both runs do the same work.
+	thread_recorder seq_threads;
+	thread_recorder par_threads;
+	const auto [seq_total, seq_ms] = time_collatz_total(std::execution::seq, range, [&seq_threads](int64_t n)
+	{
+		seq_threads.record();
+		return collatz_length(n);
+	});
+	const auto [par_total, par_ms] = time_collatz_total(std::execution::par, range, [&par_threads](int64_t n)
+	{
+		par_threads.record();
+		return collatz_length(n);
+	});
+	if (seq_total != par_total)
+	{
+		return "total mismatch";
+	}
+	return std::to_string(seq_total) + ", seq " + std::to_string(seq_ms) + "ms, par " + std::to_string(par_ms)
+		+ "ms (" + std::to_string(par_threads.num_threads()) + " threads of " + std::to_string(std::thread::hardware_concurrency())
+		+ " hardware threads), speedup " + std::to_string(seq_ms / par_ms) + "x";
+}
+
+// Unlike the benchmark, this can fail: std::execution::par must split an int_range between
+// threads, unless there's only one hardware thread to run on.
+ResultType benchmark_int_range_parallel_uses_threads()
+{
+	const utils::int_range<int64_t> range{ 1, 500'001 };
+	thread_recorder par_threads;
+	time_collatz_total(std::execution::par, range, [&par_threads](int64_t n)
+	{
+		par_threads.record();
+		return collatz_length(n);
+	});
+	if (par_threads.num_threads() == 1 && std::thread::hardware_concurrency() > 1)
+	{
+		return "par ran on one thread";
+	}
+	return "ok";
+}
+
+// Tasks that each run a parallel_reduce of their own, so tasks wait on work queued behind them.
+// With a small pool this would deadlock if waiting threads didn't help out.
+ResultType benchmark_thread_pool_nested_reduce()
+{
+	utils::thread_pool pool{ 2 };
+	std::vector<std::future<int64_t>> results;
+	for (int64_t task = 0; task < 10; ++task)
+	{
+		results.push_back(pool.submit([&pool, task]()
+		{
+			const utils::int_range<int64_t> range{ task * 100'000 + 1, (task + 1) * 100'000 + 1 };
+			return pool.parallel_reduce(range, int64_t{ 0 }, std::plus<int64_t>{}, [](int64_t i) { return i; });
+		}));
+	}
+	// Help out while waiting, as the futures may be queued behind each other.
+	int64_t result = 0;
+	for (auto& f : results)
+	{
+		while (f.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready)
+		{
+			if (!pool.run_pending_task())
+			{
+				std::this_thread::yield();
+			}
+		}
+		result += f.get();
+	}
+	return result;
+}
+
+// The same sum as benchmark_int_range_parallel_transform_reduce, with the thread pool.
+ResultType benchmark_thread_pool_parallel_reduce()
+{
+	const utils::int_range<int64_t> range{ 1, 2'000'001 };
+	const auto [seq_total, seq_ms] = time_collatz_total(std::execution::seq, range);
+	const auto start = std::chrono::steady_clock::now();
+	const int64_t pool_total = utils::parallel_reduce(range, int64_t{ 0 }, std::plus<int64_t>{}, collatz_length);
+	const double pool_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	if (seq_total != pool_total)
+	{
+		return "total mismatch";
+	}
+	return std::to_string(pool_total) + ", seq " + std::to_string(seq_ms) + "ms, pool " + std::to_string(pool_ms)
+		+ "ms (" + std::to_string(utils::default_thread_pool().size() + 1) + " threads), speedup " + std::to_string(seq_ms / pool_ms) + "x";
+}
+
+// An unbounded memo must remember everything, and a bounded one must stay within its size
+// and never return a wrong value for what it does remember.
+ResultType benchmark_memo_against_map()
+{
+	std::mt19937 gen{ 38 };
+	std::unordered_map<uint32_t, uint32_t> reference;
+	utils::memo<uint32_t, uint32_t> unbounded;
+	utils::memo<uint32_t, uint32_t> bounded{ 1000 };
+	std::size_t bounded_hits = 0;
+	for (int i = 0; i < 1'000'000; ++i)
+	{
+		const uint32_t key = gen() % 20'000;
+		if (gen() % 2 == 0)
+		{
+			const uint32_t value = gen();
+			reference[key] = value;
+			unbounded.insert(key, value);
+			bounded.insert(key, value);
+		}
+		else
+		{
+			const auto it = reference.find(key);
+			const auto expected = (it != end(reference)) ? std::optional<uint32_t>{ it->second } : std::nullopt;
+			if (unbounded.find(key) != expected)
+			{
+				return "unbounded mismatch";
+			}
+			if (const auto found = bounded.find(key))
+			{
+				if (found != expected)
+				{
+					return "bounded mismatch";
+				}
+				++bounded_hits;
+			}
+		}
+		if (bounded.size() > bounded.max_size() || bounded.capacity() > bounded.max_size())
+		{
+			return "bounded memo too big";
+		}
+	}
+	if (unbounded.size() != reference.size())
+	{
+		return "size mismatch";
+	}
+	return bounded_hits > 0 ? "ok" : "bounded memo never hit";
+}
+
+namespace
+{
+	struct constant_hash
+	{
+		std::size_t operator()(uint32_t) const noexcept { return 38; }
+	};
+}
+
+// Every key has the same hash, so they can't all fit in reach of their home slot however big the table is.
+// The unbounded memo must still keep all of them without growing out of hand, and the bounded one must not hang.
+ResultType benchmark_memo_constant_hash()
+{
+	constexpr uint32_t NUM_KEYS = 2000;
+	utils::memo<uint32_t, uint32_t, constant_hash> unbounded;
+	utils::memo<uint32_t, uint32_t, constant_hash> bounded{ 64 };
+	for (uint32_t key = 0; key < NUM_KEYS; ++key)
+	{
+		unbounded.insert(key, key * 3);
+		bounded.insert(key, key * 3);
+	}
+	if (unbounded.size() != NUM_KEYS || unbounded.capacity() > 4 * std::bit_ceil(NUM_KEYS))
+	{
+		return "unbounded memo size " + std::to_string(unbounded.size()) + ", capacity " + std::to_string(unbounded.capacity());
+	}
+	for (uint32_t key = 0; key < NUM_KEYS; ++key)
+	{
+		if (unbounded.find(key) != key * 3)
+		{
+			return "unbounded mismatch";
+		}
+		if (const auto found = bounded.find(key); found.has_value() && found != key * 3)
+		{
+			return "bounded mismatch";
+		}
+	}
+	if (bounded.size() > bounded.max_size() || bounded.find(NUM_KEYS - 1) != (NUM_KEYS - 1) * 3)
+	{
+		return "bounded memo lost the newest key";
+	}
+	return "ok";
+}
+
+// Several threads fill in a concurrent_memo of Fibonacci numbers by recursion.
+ResultType benchmark_concurrent_memo_fibonacci()
+{
+	utils::concurrent_memo<int, uint64_t> cache;
+	std::function<uint64_t(int)> fib = [&cache, &fib](int n) -> uint64_t
+	{
+		if (n < 2) return static_cast<uint64_t>(n);
+		return cache.get_or_compute(n, [&fib, n]() { return fib(n - 1) + fib(n - 2); });
+	};
+	std::vector<std::thread> threads;
+	std::vector<uint64_t> results(4);
+	for (int t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&fib, &result = results[t], t]() { result = fib(80 + t); });
+	}
+	for (auto& t : threads) t.join();
+	if (results[1] != results[0] + fib(79) || results[3] != results[2] + results[1])
+	{
+		return "inconsistent";
+	}
+	return static_cast<int64_t>(results[0]);
+}
+
+namespace
+{
+	// The isqrt from before it was made constexpr, to compare against.
+	uint32_t previous_isqrt_implementation(uint32_t guess_base, uint32_t input)
+	{
+		uint64_t guess = 1;
+		while (true)
+		{
+			const uint64_t trial_result = guess_base + guess;
+			const uint64_t trial_square = trial_result * trial_result;
+			if (trial_square == input)
+			{
+				return static_cast<uint32_t>(trial_result);
+			}
+			else if (trial_square < input)
+			{
+				guess *= 2;
+			}
+			else if (guess == 1)
+			{
+				return guess_base;
+			}
+			else
+			{
+				return previous_isqrt_implementation(guess_base + static_cast<uint32_t>(guess / 2), input);
+			}
+		}
+	}
+
+	uint32_t previous_isqrt(uint32_t input)
+	{
+		return input == 0 ? 0 : previous_isqrt_implementation(0, input);
+	}
+
+	template <typename Func>
+	std::pair<uint64_t, double> time_isqrt(const std::vector<uint32_t>& inputs, Func isqrt_func)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		uint64_t total = 0;
+		for (uint32_t input : inputs)
+		{
+			total += isqrt_func(input);
+		}
+		const auto time_taken = std::chrono::steady_clock::now() - start;
+		return std::pair{ total, std::chrono::duration_cast<std::chrono::nanoseconds>(time_taken).count() / static_cast<double>(inputs.size()) };
+	}
+}
+
+// Checks the run time version against the bitwise one used in constant expressions, then times it against the previous isqrt.
+ResultType benchmark_isqrt_against_previous()
+{
+	std::mt19937_64 gen{ 39 };
+	for (int i = 0; i < 1'000'000; ++i)
+	{
+		// Squares and their neighbours are where the double estimate is most likely to be out.
+		const uint64_t root = gen() >> 32;
+		for (const uint64_t input : { root * root - 1, root * root, root * root + 1, gen(), gen() >> (gen() % 64) })
+		{
+			if (utils::isqrt(input) != utils::internals::isqrt_bitwise(input))
+			{
+				return "mismatch for " + std::to_string(input);
+			}
+		}
+	}
+
+	std::vector<uint32_t> inputs(NUM_QUERIES);
+	std::generate(begin(inputs), end(inputs), [&gen]() { return static_cast<uint32_t>(gen()); });
+	const auto [previous_total, previous_ns] = time_isqrt(inputs, previous_isqrt);
+	const auto [new_total, new_ns] = time_isqrt(inputs, [](uint32_t input) { return utils::isqrt(input); });
+	const auto [bitwise_total, bitwise_ns] = time_isqrt(inputs, utils::internals::isqrt_bitwise);
+	if (previous_total != new_total || previous_total != bitwise_total)
+	{
+		return "total mismatch";
+	}
+	return "previous " + std::to_string(previous_ns) + "ns, isqrt " + std::to_string(new_ns) + "ns, bitwise " + std::to_string(bitwise_ns) + "ns";
+}
+
+// The SIMD scans against simple loops, on strings of every length up to 100 made mostly of the
+// characters being looked for, so that the misses land in every position.
+ResultType benchmark_char_class_against_scalar()
+{
+	std::mt19937 gen{ 40 };
+	const utils::char_class classes[] = { utils::digit_chars, utils::space_chars, utils::hex_chars,
+		utils::char_class::of("acegikmoqsuwy"), utils::char_class::of("\x80\xff") };
+	const std::string_view common_chars = "0123456789abcdefABCDEF \t\n\r\v\f\x80\xff";
+	for (int i = 0; i < 100'000; ++i)
+	{
+		std::string str(gen() % 100, ' ');
+		for (char& c : str)
+		{
+			c = (gen() % 8 != 0) ? common_chars[gen() % common_chars.size()] : static_cast<char>(gen());
+		}
+		for (const utils::char_class& cls : classes)
+		{
+			const auto in_class = [&cls](char c) { return cls.contains(c); };
+			const auto first = std::find_if_not(begin(str), end(str), in_class);
+			const std::size_t expected_first = first != end(str) ? static_cast<std::size_t>(first - begin(str)) : std::string_view::npos;
+			const auto last = std::find_if_not(rbegin(str), rend(str), in_class);
+			const std::size_t expected_last = last != rend(str) ? static_cast<std::size_t>(rend(str) - last - 1) : std::string_view::npos;
+			if (utils::find_first_not_in(str, cls) != expected_first || utils::find_last_not_in(str, cls) != expected_last)
+			{
+				return "find mismatch";
+			}
+		}
+		const char target = str.empty() ? 'a' : str[gen() % str.size()];
+		if (utils::count_char(str, target) != static_cast<std::size_t>(std::count(begin(str), end(str), target)))
+		{
+			return "count mismatch";
+		}
+		const auto is_space = [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; };
+		const auto trim_first = std::find_if_not(begin(str), end(str), is_space);
+		const auto trim_last = std::find_if_not(rbegin(str), rend(str), is_space).base();
+		const std::string expected_trim = trim_first < trim_last ? std::string(trim_first, trim_last) : std::string{};
+		if (utils::trim_string(str) != expected_trim)
+		{
+			return "trim mismatch";
+		}
+	}
+	return "ok";
+}
+
+namespace
+{
+	// Tries every set of k positions.
+	bool brute_force_k_sum(const std::vector<int64_t>& values, std::size_t first, std::size_t k, int64_t target)
+	{
+		if (k == 0)
+		{
+			return target == 0;
+		}
+		for (std::size_t i = first; i < values.size(); ++i)
+		{
+			if (brute_force_k_sum(values, i + 1, k - 1, target - values[i]))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+// Every strategy against brute force, on short lists with lots of repeated values.
+// Half of them have negative values, and the other half are spread over a few words of a bitmap.
+ResultType benchmark_k_sum_against_brute_force()
+{
+	std::mt19937 gen{ 41 };
+	const utils::k_sum_strategy strategies[] = { utils::k_sum_strategy::automatic, utils::k_sum_strategy::two_pointer,
+		utils::k_sum_strategy::hash_set, utils::k_sum_strategy::meet_in_the_middle, utils::k_sum_strategy::bitmap };
+	for (int i = 0; i < 20'000; ++i)
+	{
+		const bool has_negatives = (i % 2 == 0);
+		const int64_t lowest = has_negatives ? -20 : 0;
+		const int64_t highest = has_negatives ? 20 : 150;
+		std::vector<int64_t> values(gen() % 13);
+		std::generate(begin(values), end(values), [&]() { return lowest + static_cast<int64_t>(gen() % (highest - lowest + 1)); });
+		const std::size_t k = 1 + gen() % 6;
+		const int64_t target = 2 * lowest + static_cast<int64_t>(gen() % (2 * (highest - lowest) + 1));
+		const bool expected = brute_force_k_sum(values, 0, k, target);
+		for (utils::k_sum_strategy strategy : strategies)
+		{
+			if (has_negatives && strategy == utils::k_sum_strategy::bitmap)
+			{
+				continue;
+			}
+			const auto result = utils::find_k_sum(values, k, target, strategy);
+			if (result.has_value() != expected)
+			{
+				return "wrong answer";
+			}
+			if (!result.has_value())
+			{
+				continue;
+			}
+			const std::vector<std::size_t>& indices = *result;
+			int64_t sum = 0;
+			for (std::size_t idx : indices)
+			{
+				sum += values[idx];
+			}
+			if (indices.size() != k || std::adjacent_find(begin(indices), end(indices)) != end(indices) || sum != target)
+			{
+				return "bad indices";
+			}
+		}
+	}
+	return "ok";
+}
+
+namespace
+{
+	bool is_k_sum(const std::vector<int64_t>& values, const std::optional<std::vector<std::size_t>>& indices, std::size_t k, int64_t target)
+	{
+		if (!indices.has_value() || indices->size() != k || std::adjacent_find(begin(*indices), end(*indices)) != end(*indices))
+		{
+			return false;
+		}
+		int64_t sum = 0;
+		for (std::size_t idx : *indices)
+		{
+			sum += values[idx];
+		}
+		return sum == target;
+	}
+}
+
+// Lists far too long for brute force. With 4000 values automatic has to use meet_in_the_middle for k = 4,
+// both for a target that can be reached and for one that can't, which is the slow case.
+// k = 5 and 6 use smaller values, so that there are plenty of ways to reach the target.
+ResultType benchmark_k_sum_thousands_of_values()
+{
+	std::mt19937_64 gen{ 41 };
+	std::vector<int64_t> values(4000);
+	// All even, so an odd target can't be reached.
+	std::generate(begin(values), end(values), [&gen]() { return 2 * static_cast<int64_t>(gen() % 1'000'000'000'000); });
+	const auto [min_it, max_it] = std::minmax_element(begin(values), end(values));
+	if (utils::choose_k_sum_strategy(values.size(), 4, *min_it, *max_it) != utils::k_sum_strategy::meet_in_the_middle)
+	{
+		return "meet_in_the_middle not chosen";
+	}
+	const int64_t reachable = values[12] + values[345] + values[2020] + values[3999];
+	if (!is_k_sum(values, utils::find_k_sum(values, 4, reachable), 4, reachable))
+	{
+		return "missed a reachable k = 4 target";
+	}
+	if (utils::find_k_sum(values, 4, int64_t{ 4'000'000'000'001 }).has_value())
+	{
+		return "reached an odd k = 4 target";
+	}
+	std::vector<int64_t> small_values(1000);
+	std::generate(begin(small_values), end(small_values), [&gen]() { return static_cast<int64_t>(gen() % 1'000'000); });
+	for (std::size_t k = 5; k <= 6; ++k)
+	{
+		const auto target = static_cast<int64_t>(k * 500'000);
+		if (!is_k_sum(small_values, utils::find_k_sum(small_values, k, target), k, target))
+		{
+			return "missed a k = " + std::to_string(k) + " target";
+		}
+	}
+	return "ok";
+}
+
+// Random batches of random strings against counting one string at a time. The strings are mostly
+// made of a few letters, so there are plenty of matches, with the odd byte of anything else.
+ResultType benchmark_char_count_batch_against_scalar()
+{
+	std::mt19937 gen{ 44 };
+	utils::char_count_batch batch;
+	std::vector<std::string> strings;
+	std::vector<char> chars;
+	std::vector<std::pair<uint8_t, uint8_t>> ranges;
+	for (int i = 0; i < 20'000; ++i)
+	{
+		batch.clear();
+		strings.clear();
+		chars.clear();
+		ranges.clear();
+		const std::size_t batch_size = gen() % (utils::char_count_batch::NUM_LANES + 1);
+		for (std::size_t lane = 0; lane < batch_size; ++lane)
+		{
+			std::string str(gen() % (utils::char_count_batch::MAX_LENGTH + 1), ' ');
+			for (char& c : str)
+			{
+				c = (gen() % 8 != 0) ? static_cast<char>('a' + gen() % 3) : static_cast<char>(gen());
+			}
+			const char c = (gen() % 8 != 0) ? static_cast<char>('a' + gen() % 3) : static_cast<char>(gen());
+			const auto min_count = static_cast<uint8_t>(gen() % 20);
+			const auto max_count = static_cast<uint8_t>(min_count + gen() % 20);
+			batch.add(str, c, min_count, max_count);
+			strings.push_back(std::move(str));
+			chars.push_back(c);
+			ranges.emplace_back(min_count, max_count);
+		}
+		const auto counts = batch.counts();
+		std::size_t expected_in_range = 0;
+		for (std::size_t lane = 0; lane < batch_size; ++lane)
+		{
+			const std::size_t expected = utils::count_char(strings[lane], chars[lane]);
+			if (counts[lane] != expected)
+			{
+				return "count mismatch";
+			}
+			expected_in_range += (ranges[lane].first <= expected && expected <= ranges[lane].second) ? 1 : 0;
+		}
+		if (batch.count_in_range() != expected_in_range)
+		{
+			return "range mismatch";
+		}
+	}
+	return "ok";
+}
+
+// Builds random text out of known records, with blank lines of various kinds between them,
+// then checks the records and their lines come back out, both whole and in every number of chunks.
+ResultType benchmark_record_range_split()
+{
+	std::mt19937 gen{ 47 };
+	const std::string_view blank_lines[] = { "\n", "\r\n", "  \n", "\t\r\n" };
+	const std::string_view line_ends[] = { "\n", "\r\n" };
+	for (int i = 0; i < 2'000; ++i)
+	{
+		std::vector<std::vector<std::string>> records(gen() % 10);
+		std::string text;
+		for (std::size_t blanks = gen() % 3; blanks > 0; --blanks)
+		{
+			text.append(blank_lines[gen() % std::size(blank_lines)]);
+		}
+		for (std::size_t r = 0; r < records.size(); ++r)
+		{
+			if (r > 0)
+			{
+				for (std::size_t blanks = 1 + gen() % 3; blanks > 0; --blanks)
+				{
+					text.append(blank_lines[gen() % std::size(blank_lines)]);
+				}
+			}
+			const std::size_t num_lines = 1 + gen() % 4;
+			for (std::size_t l = 0; l < num_lines; ++l)
+			{
+				std::string line(1 + gen() % 8, 'a');
+				std::generate(begin(line), end(line), [&gen]() { return static_cast<char>('a' + gen() % 26); });
+				text.append(line);
+				// Leave the final line ending off sometimes.
+				if (l + 1 < num_lines || r + 1 < records.size() || gen() % 2 == 0)
+				{
+					text.append(line_ends[gen() % std::size(line_ends)]);
+				}
+				records[r].push_back(std::move(line));
+			}
+		}
+
+		for (std::size_t num_chunks = 1; num_chunks < 12; ++num_chunks)
+		{
+			std::vector<std::vector<std::string>> found;
+			const std::vector<std::string_view> chunks = utils::split_records_into_chunks(text, num_chunks);
+			if (chunks.size() > num_chunks)
+			{
+				return "too many chunks";
+			}
+			for (std::string_view chunk : chunks)
+			{
+				for (std::string_view record : utils::record_range{ chunk })
+				{
+					std::vector<std::string>& lines = found.emplace_back();
+					for (std::string_view line : utils::line_range{ record })
+					{
+						lines.emplace_back(line);
+					}
+				}
+			}
+			if (found != records)
+			{
+				return "records differ";
+			}
+		}
+	}
+	return "ok";
+}
@@ -6,6 +6,11 @@
 #include <cmath>
 #include <array>
 #include <iostream>
+#include <functional>
+#include <type_traits>
+#include <cstdint>
+
+#include "hash_combine.h"
 
 namespace utils
 {
@@ -56,9 +61,9 @@ namespace utils
 		auto reduce() const noexcept;
 		auto manhatten_distance() const noexcept { return std::abs(x) + std::abs(y); }
 		auto manhatten_distance(const BasicCoords& other) const noexcept;
-		BasicCoords(T x_, T y_) : x{ x_ }, y{ y_ }{}
-		BasicCoords(T init) : BasicCoords{ init,init } {}
-		BasicCoords() : BasicCoords{ 0 } {}
+		constexpr BasicCoords(T x_, T y_) : x{ x_ }, y{ y_ }{}
+		constexpr BasicCoords(T init) : BasicCoords{ init,init } {}
+		constexpr BasicCoords() : BasicCoords{ 0 } {}
 
 		BasicCoords& operator=(const BasicCoords&) noexcept = default;
 
@@ -216,4 +221,105 @@ namespace utils
 		out << "{ " << c.x << " , " << c.y << " }";
 		return out;
 	}
+
+	// Stores x in the high 32 bits and y in the low 32 bits. Equal coords give equal keys,
+	// but the ordering is only the same as operator<=> for non-negative coords.
+	template <typename T>
+	constexpr uint64_t pack_coords(const BasicCoords<T>& c) noexcept
+	{
+		static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(uint32_t), "Only coords of up to 32 bits can be packed");
+		return (static_cast<uint64_t>(static_cast<uint32_t>(c.x)) << 32) | static_cast<uint32_t>(c.y);
+	}
+
+	template <typename T>
+	constexpr BasicCoords<T> unpack_coords(uint64_t packed) noexcept
+	{
+		static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(uint32_t), "Only coords of up to 32 bits can be packed");
+		const auto x = static_cast<int32_t>(static_cast<uint32_t>(packed >> 32));
+		const auto y = static_cast<int32_t>(static_cast<uint32_t>(packed));
+		return BasicCoords<T>{ static_cast<T>(x), static_cast<T>(y) };
+	}
+
+	namespace internals
+	{
+		// Moves bit i of the input to bit 2i of the output.
+		constexpr uint64_t spread_bits(uint32_t in) noexcept
+		{
+			uint64_t v = in;
+			v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+			v = (v | (v << 8)) & 0x00FF00FF00FF00FFULL;
+			v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+			v = (v | (v << 2)) & 0x3333333333333333ULL;
+			v = (v | (v << 1)) & 0x5555555555555555ULL;
+			return v;
+		}
+
+		// The inverse of spread_bits. Odd bits are ignored.
+		constexpr uint32_t compact_bits(uint64_t v) noexcept
+		{
+			v &= 0x5555555555555555ULL;
+			v = (v | (v >> 1)) & 0x3333333333333333ULL;
+			v = (v | (v >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+			v = (v | (v >> 4)) & 0x00FF00FF00FF00FFULL;
+			v = (v | (v >> 8)) & 0x0000FFFF0000FFFFULL;
+			v = (v | (v >> 16)) & 0x00000000FFFFFFFFULL;
+			return static_cast<uint32_t>(v);
+		}
+
+		// Flipping the sign bit maps signed values onto unsigned ones in the same order.
+		template <typename T>
+		constexpr uint32_t morton_bias() noexcept
+		{
+			return std::is_signed_v<T> ? 0x80000000u : 0u;
+		}
+	}
+
+	// Z-order curve: interleaves the bits of x (even bits) and y (odd bits). Points that are
+	// close together in 2D tend to be close together in the key order, so sorting by
+	// this key gives a cache-friendly order to visit points in.
+	template <typename T>
+	constexpr uint64_t morton_encode(const BasicCoords<T>& c) noexcept
+	{
+		static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(uint32_t), "Only coords of up to 32 bits can be Morton encoded");
+		const uint32_t x = static_cast<uint32_t>(c.x) ^ internals::morton_bias<T>();
+		const uint32_t y = static_cast<uint32_t>(c.y) ^ internals::morton_bias<T>();
+		return internals::spread_bits(x) | (internals::spread_bits(y) << 1);
+	}
+
+	template <typename T>
+	constexpr BasicCoords<T> morton_decode(uint64_t code) noexcept
+	{
+		static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(uint32_t), "Only coords of up to 32 bits can be Morton encoded");
+		const uint32_t x = internals::compact_bits(code) ^ internals::morton_bias<T>();
+		const uint32_t y = internals::compact_bits(code >> 1) ^ internals::morton_bias<T>();
+		return BasicCoords<T>{ static_cast<T>(static_cast<int32_t>(x)), static_cast<T>(static_cast<int32_t>(y)) };
+	}
+
+	namespace internals
+	{
+		static_assert(unpack_coords<int>(pack_coords(Coords{ -3,7 })) == Coords{ -3,7 });
+		static_assert(unpack_coords<int>(pack_coords(Coords{ 2147483647,-2147483647 - 1 })) == Coords{ 2147483647,-2147483647 - 1 });
+		static_assert(pack_coords(Coords{ 1,2 }) == 0x0000000100000002ULL);
+		static_assert(morton_decode<int>(morton_encode(Coords{ -5,12 })) == Coords{ -5,12 });
+		static_assert(morton_encode(BasicCoords<unsigned>{ 3u,0u }) == 5);
+		static_assert(morton_encode(BasicCoords<unsigned>{ 0u,1u }) == 2);
+		static_assert(morton_encode(Coords{ -1,-1 }) < morton_encode(Coords{ 0,0 }));
+	}
 }
+
+template <typename T>
+struct std::hash<utils::BasicCoords<T>>
+{
+	std::size_t operator()(const utils::BasicCoords<T>& c) const noexcept
+	{
+		if constexpr (std::is_integral_v<T> && sizeof(T) <= sizeof(uint32_t))
+		{
+			return static_cast<std::size_t>(utils::hash_mix(utils::pack_coords(c)));
+		}
+		else
+		{
+			const uint64_t seed = utils::hash_combine(0, std::hash<T>{}(c.x));
+			return static_cast<std::size_t>(utils::hash_mix(utils::hash_combine(seed, std::hash<T>{}(c.y))));
+		}
+	}
+};
@@ -2,6 +2,8 @@
 
 #include <fstream>
 #include <sstream>
+#include <string>
+#include <iterator>
 #include <cassert>
 
 namespace utils
@@ -24,4 +26,10 @@ namespace utils
 		assert(result.is_open());
 		return result;
 	}
+
+	// For inputs that are easier to handle all at once, such as with record_range.
+	inline std::string read_whole_stream(std::istream& input)
+	{
+		return std::string{ std::istreambuf_iterator<char>{ input }, std::istreambuf_iterator<char>{} };
+	}
 }
@@ -0,0 +1,237 @@
+#pragma once
+
+// Sets of characters, and fast scans over strings for them.
+// A char_class is stored both as a 256-bit table, for testing single characters, and as a short
+// list of ranges like '0'-'9'. With SSE2 the scans test 16 characters at a time against the ranges.
+// Classes with too many ranges (more than MAX_RANGES) still work, but are scanned one character at a time.
+//
+// Unlike ::isspace and friends, these don't depend on the locale, and are fine with negative chars.
+
+#include <array>
+#include <string_view>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTILS_CHAR_CLASS_SSE2 1
+#include <emmintrin.h>
+#else
+#define UTILS_CHAR_CLASS_SSE2 0
+#endif
+
+namespace utils
+{
+	class char_class
+	{
+	public:
+		static constexpr std::size_t MAX_RANGES = 8;
+	private:
+		struct char_range
+		{
+			uint8_t first = 0;
+			uint8_t last = 0;
+		};
+
+		std::array<uint64_t, 4> m_table{};
+		std::array<char_range, MAX_RANGES> m_ranges{};
+		std::size_t m_num_ranges = 0;
+		bool m_too_many_ranges = false;
+
+		constexpr void add_range(uint8_t first, uint8_t last) noexcept
+		{
+			assert(first <= last);
+			for (unsigned c = first; c <= last; ++c)
+			{
+				m_table[c / 64] |= uint64_t{ 1 } << (c % 64);
+			}
+			// Join onto the end of the last range if possible, so that of("abc") is one range.
+			if (m_num_ranges > 0 && m_ranges[m_num_ranges - 1].last + 1 == first)
+			{
+				m_ranges[m_num_ranges - 1].last = last;
+			}
+			else if (m_num_ranges < MAX_RANGES)
+			{
+				m_ranges[m_num_ranges++] = char_range{ first, last };
+			}
+			else
+			{
+				m_too_many_ranges = true;
+			}
+		}
+	public:
+		constexpr char_class() noexcept = default;
+
+		// Both ends are included.
+		static constexpr char_class range(char first, char last) noexcept
+		{
+			char_class result;
+			result.add_range(static_cast<uint8_t>(first), static_cast<uint8_t>(last));
+			return result;
+		}
+
+		static constexpr char_class of(std::string_view chars) noexcept
+		{
+			char_class result;
+			for (char c : chars)
+			{
+				if (!result.contains(c))
+				{
+					result.add_range(static_cast<uint8_t>(c), static_cast<uint8_t>(c));
+				}
+			}
+			return result;
+		}
+
+		constexpr char_class operator|(const char_class& other) const noexcept
+		{
+			char_class result = *this;
+			for (std::size_t i = 0; i < other.m_num_ranges; ++i)
+			{
+				result.add_range(other.m_ranges[i].first, other.m_ranges[i].last);
+			}
+			if (other.m_too_many_ranges)
+			{
+				for (std::size_t i = 0; i < m_table.size(); ++i)
+				{
+					result.m_table[i] |= other.m_table[i];
+				}
+				result.m_too_many_ranges = true;
+			}
+			return result;
+		}
+
+		constexpr bool contains(char c) const noexcept
+		{
+			const auto uc = static_cast<uint8_t>(c);
+			return (m_table[uc / 64] >> (uc % 64)) & 1;
+		}
+
+		// Whether the SIMD scans can be used.
+		constexpr bool vectorizable() const noexcept { return !m_too_many_ranges; }
+
+#if UTILS_CHAR_CLASS_SSE2
+		// 0xFF in each byte of the result where that byte of chars is in the class.
+		__m128i contains(__m128i chars) const noexcept
+		{
+			assert(vectorizable());
+			__m128i result = _mm_setzero_si128();
+			for (std::size_t i = 0; i < m_num_ranges; ++i)
+			{
+				// c is in [first, last] if c - first (wrapping) <= last - first, compared unsigned.
+				const __m128i offset = _mm_sub_epi8(chars, _mm_set1_epi8(static_cast<char>(m_ranges[i].first)));
+				const __m128i width = _mm_set1_epi8(static_cast<char>(m_ranges[i].last - m_ranges[i].first));
+				result = _mm_or_si128(result, _mm_cmpeq_epi8(_mm_min_epu8(offset, width), offset));
+			}
+			return result;
+		}
+#endif
+	};
+
+	inline constexpr char_class digit_chars = char_class::range('0', '9');
+	// The same as ::isspace in the "C" locale.
+	inline constexpr char_class space_chars = char_class::range('\t', '\r') | char_class::of(" ");
+	inline constexpr char_class hex_chars = char_class::range('0', '9') | char_class::range('a', 'f') | char_class::range('A', 'F');
+	inline constexpr char_class lower_hex_chars = char_class::range('0', '9') | char_class::range('a', 'f');
+
+	namespace internals
+	{
+#if UTILS_CHAR_CLASS_SSE2
+		constexpr std::size_t CHAR_SCAN_WIDTH = 16;
+
+		inline __m128i load_chars(const char* data) noexcept
+		{
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+		}
+
+		// One bit per character, set for the characters that are not in the class.
+		inline uint32_t chars_not_in_class(const char* data, const char_class& cls) noexcept
+		{
+			return static_cast<uint32_t>(~_mm_movemask_epi8(cls.contains(load_chars(data)))) & 0xFFFF;
+		}
+#endif
+	}
+
+	// Returns the index of the first character that isn't in the class, or npos if they all are.
+	inline std::size_t find_first_not_in(std::string_view str, const char_class& cls) noexcept
+	{
+		std::size_t i = 0;
+#if UTILS_CHAR_CLASS_SSE2
+		if (cls.vectorizable())
+		{
+			for (; i + internals::CHAR_SCAN_WIDTH <= str.size(); i += internals::CHAR_SCAN_WIDTH)
+			{
+				if (const uint32_t misses = internals::chars_not_in_class(str.data() + i, cls))
+				{
+					return i + std::countr_zero(misses);
+				}
+			}
+		}
+#endif
+		for (; i < str.size(); ++i)
+		{
+			if (!cls.contains(str[i])) return i;
+		}
+		return std::string_view::npos;
+	}
+
+	// Returns the index of the last character that isn't in the class, or npos if they all are.
+	inline std::size_t find_last_not_in(std::string_view str, const char_class& cls) noexcept
+	{
+		std::size_t end = str.size();
+#if UTILS_CHAR_CLASS_SSE2
+		if (cls.vectorizable())
+		{
+			for (; end >= internals::CHAR_SCAN_WIDTH; end -= internals::CHAR_SCAN_WIDTH)
+			{
+				const std::size_t first = end - internals::CHAR_SCAN_WIDTH;
+				if (const uint32_t misses = internals::chars_not_in_class(str.data() + first, cls))
+				{
+					return first + std::bit_width(misses) - 1;
+				}
+			}
+		}
+#endif
+		while (end > 0)
+		{
+			--end;
+			if (!cls.contains(str[end])) return end;
+		}
+		return std::string_view::npos;
+	}
+
+	inline bool all_in(std::string_view str, const char_class& cls) noexcept
+	{
+		return find_first_not_in(str, cls) == std::string_view::npos;
+	}
+
+	inline std::size_t count_char(std::string_view str, char c) noexcept
+	{
+		std::size_t result = 0;
+		std::size_t i = 0;
+#if UTILS_CHAR_CLASS_SSE2
+		const __m128i target = _mm_set1_epi8(c);
+		for (; i + internals::CHAR_SCAN_WIDTH <= str.size(); i += internals::CHAR_SCAN_WIDTH)
+		{
+			const __m128i matches = _mm_cmpeq_epi8(internals::load_chars(str.data() + i), target);
+			result += std::popcount(static_cast<uint32_t>(_mm_movemask_epi8(matches)));
+		}
+#endif
+		for (; i < str.size(); ++i)
+		{
+			result += (str[i] == c) ? 1 : 0;
+		}
+		return result;
+	}
+
+	namespace internals
+	{
+		static_assert(digit_chars.contains('0') && digit_chars.contains('9') && !digit_chars.contains('a'));
+		static_assert(space_chars.contains(' ') && space_chars.contains('\n') && space_chars.contains('\v') && !space_chars.contains('x'));
+		static_assert(hex_chars.contains('F') && hex_chars.contains('a') && !hex_chars.contains('g'));
+		static_assert(char_class::of("abc").contains('b') && !char_class::of("abc").contains('d'));
+		static_assert(!char_class::of("\x80").contains('\x7f') && char_class::of("\x80").contains('\x80'));
+		static_assert(char_class::of("acegikmoqsuwy").vectorizable() == false);
+	}
+}
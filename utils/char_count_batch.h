@@ -0,0 +1,127 @@
+#pragma once
+
+// Counts a character in up to 16 short strings at once, each with its own character, and checks
+// each count against its own [min, max] range.
+// The strings are stored a column each: byte j of every string is in row j. With SSE2, one compare
+// handles a row of all 16 strings, and subtracting the resulting masks keeps a running count per string.
+// The range checks are done the same way, and a popcount of the mask of passing strings finishes it off.
+//
+// Only strings of up to MAX_LENGTH characters fit. Anything longer needs counting some other way.
+
+#include "char_class.h"
+
+#include <array>
+#include <string_view>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace utils
+{
+	class char_count_batch
+	{
+	public:
+		static constexpr std::size_t NUM_LANES = 16;
+		static constexpr std::size_t MAX_LENGTH = 32;
+	private:
+		// Bytes past the end of a string hold something other than its character, so they never count.
+		alignas(16) std::array<std::array<char, NUM_LANES>, MAX_LENGTH> m_rows{};
+		alignas(16) std::array<char, NUM_LANES> m_chars{};
+		alignas(16) std::array<uint8_t, NUM_LANES> m_min_counts{};
+		alignas(16) std::array<uint8_t, NUM_LANES> m_max_counts{};
+		std::size_t m_size = 0;
+		std::size_t m_longest = 0;
+
+#if UTILS_CHAR_CLASS_SSE2
+		static __m128i load_lanes(const void* data) noexcept
+		{
+			return _mm_load_si128(static_cast<const __m128i*>(data));
+		}
+#endif
+	public:
+		std::size_t size() const noexcept { return m_size; }
+		bool empty() const noexcept { return m_size == 0; }
+		bool full() const noexcept { return m_size == NUM_LANES; }
+
+		static constexpr bool fits(std::string_view str) noexcept
+		{
+			return str.size() <= MAX_LENGTH;
+		}
+
+		void add(std::string_view str, char c, uint8_t min_count, uint8_t max_count) noexcept
+		{
+			assert(!full());
+			assert(fits(str));
+			const std::size_t lane = m_size++;
+			const char padding = static_cast<char>(~c);
+			for (std::size_t row = 0; row < MAX_LENGTH; ++row)
+			{
+				m_rows[row][lane] = row < str.size() ? str[row] : padding;
+			}
+			m_chars[lane] = c;
+			m_min_counts[lane] = min_count;
+			m_max_counts[lane] = max_count;
+			m_longest = std::max(m_longest, str.size());
+		}
+
+		void clear() noexcept
+		{
+			m_size = 0;
+			m_longest = 0;
+		}
+
+		// How many times each string has its character. Lanes past size() are meaningless.
+		std::array<uint8_t, NUM_LANES> counts() const noexcept
+		{
+			alignas(16) std::array<uint8_t, NUM_LANES> result{};
+#if UTILS_CHAR_CLASS_SSE2
+			const __m128i chars = load_lanes(m_chars.data());
+			__m128i totals = _mm_setzero_si128();
+			for (std::size_t row = 0; row < m_longest; ++row)
+			{
+				// A match is 0xFF, which is -1, so subtracting adds one.
+				totals = _mm_sub_epi8(totals, _mm_cmpeq_epi8(load_lanes(m_rows[row].data()), chars));
+			}
+			_mm_store_si128(reinterpret_cast<__m128i*>(result.data()), totals);
+#else
+			for (std::size_t row = 0; row < m_longest; ++row)
+			{
+				for (std::size_t lane = 0; lane < NUM_LANES; ++lane)
+				{
+					result[lane] += (m_rows[row][lane] == m_chars[lane]) ? 1 : 0;
+				}
+			}
+#endif
+			return result;
+		}
+
+		// How many of the strings have a count in their range.
+		std::size_t count_in_range() const noexcept
+		{
+			if (m_size == 0)
+			{
+				return 0;
+			}
+#if UTILS_CHAR_CLASS_SSE2
+			alignas(16) const std::array<uint8_t, NUM_LANES> lane_counts = counts();
+			const __m128i totals = load_lanes(lane_counts.data());
+			// count >= min if max(count, min) == count, and count <= max if min(count, max) == count.
+			const __m128i above_min = _mm_cmpeq_epi8(_mm_max_epu8(totals, load_lanes(m_min_counts.data())), totals);
+			const __m128i below_max = _mm_cmpeq_epi8(_mm_min_epu8(totals, load_lanes(m_max_counts.data())), totals);
+			const auto in_range = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(above_min, below_max)));
+			const uint32_t used_lanes = (uint32_t{ 1 } << m_size) - 1;
+			return std::popcount(in_range & used_lanes);
+#else
+			const std::array<uint8_t, NUM_LANES> lane_counts = counts();
+			std::size_t result = 0;
+			for (std::size_t lane = 0; lane < m_size; ++lane)
+			{
+				result += (m_min_counts[lane] <= lane_counts[lane] && lane_counts[lane] <= m_max_counts[lane]) ? 1 : 0;
+			}
+			return result;
+#endif
+		}
+	};
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+// Bounded lock-free queues for handing work between threads, such as parsing on one thread
+// while solving on another. Both have a fixed power-of-two capacity and never allocate after construction.
+// try_push and try_pop never wait. push and pop yield until they can go ahead.
+
+#include <vector>
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <bit>
+#include <memory>
+#include <algorithm>
+#include <cstddef>
+#include <cassert>
+
+namespace utils
+{
+	namespace internals
+	{
+		// Keeps atomics written by different threads on different cache lines.
+		inline constexpr std::size_t QUEUE_ALIGNMENT = 64;
+	}
+
+	// One thread pushes and one (other) thread pops.
+	template <typename T>
+	class spsc_ring_buffer
+	{
+		std::vector<T> m_data;
+		std::size_t m_mask;
+
+		// The producer owns m_tail and keeps a possibly stale copy of m_head, and vice versa.
+		// Reading the other side's index only when the copy says the queue is full (or empty)
+		// keeps the cache lines from bouncing between the threads.
+		alignas(internals::QUEUE_ALIGNMENT) std::atomic<std::size_t> m_head{ 0 };
+		std::size_t m_cached_tail = 0;
+		alignas(internals::QUEUE_ALIGNMENT) std::atomic<std::size_t> m_tail{ 0 };
+		std::size_t m_cached_head = 0;
+	public:
+		using value_type = T;
+
+		// Capacity is rounded up to a power of two.
+		explicit spsc_ring_buffer(std::size_t capacity)
+			: m_data(std::bit_ceil(std::max<std::size_t>(capacity, 2)))
+			, m_mask{ m_data.size() - 1 }
+		{
+		}
+		spsc_ring_buffer(const spsc_ring_buffer&) = delete;
+		spsc_ring_buffer& operator=(const spsc_ring_buffer&) = delete;
+
+		std::size_t capacity() const noexcept { return m_data.size(); }
+
+		// Producer only.
+		template <typename U>
+		bool try_push(U&& value)
+		{
+			const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+			if (tail - m_cached_head == m_data.size())
+			{
+				m_cached_head = m_head.load(std::memory_order_acquire);
+				if (tail - m_cached_head == m_data.size())
+				{
+					return false;
+				}
+			}
+			m_data[tail & m_mask] = std::forward<U>(value);
+			m_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer only.
+		std::optional<T> try_pop()
+		{
+			const std::size_t head = m_head.load(std::memory_order_relaxed);
+			if (head == m_cached_tail)
+			{
+				m_cached_tail = m_tail.load(std::memory_order_acquire);
+				if (head == m_cached_tail)
+				{
+					return std::nullopt;
+				}
+			}
+			std::optional<T> result{ std::move(m_data[head & m_mask]) };
+			m_head.store(head + 1, std::memory_order_release);
+			return result;
+		}
+
+		template <typename U>
+		void push(U&& value)
+		{
+			while (!try_push(std::forward<U>(value)))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		T pop()
+		{
+			while (true)
+			{
+				if (auto result = try_pop())
+				{
+					return std::move(*result);
+				}
+				std::this_thread::yield();
+			}
+		}
+	};
+
+	// Any number of threads push and pop. Each slot has a sequence number that says whose turn it
+	// is: a producer may write slot i when its sequence is i, and a consumer may read it when it is i+1.
+	template <typename T>
+	class mpmc_ring_buffer
+	{
+		struct alignas(internals::QUEUE_ALIGNMENT) Slot
+		{
+			std::atomic<std::size_t> sequence;
+			T value;
+		};
+
+		std::unique_ptr<Slot[]> m_slots;
+		std::size_t m_capacity;
+		std::size_t m_mask;
+		alignas(internals::QUEUE_ALIGNMENT) std::atomic<std::size_t> m_head{ 0 };
+		alignas(internals::QUEUE_ALIGNMENT) std::atomic<std::size_t> m_tail{ 0 };
+	public:
+		using value_type = T;
+
+		// Capacity is rounded up to a power of two.
+		explicit mpmc_ring_buffer(std::size_t capacity)
+			: m_slots{ std::make_unique<Slot[]>(std::bit_ceil(std::max<std::size_t>(capacity, 2))) }
+			, m_capacity{ std::bit_ceil(std::max<std::size_t>(capacity, 2)) }
+			, m_mask{ m_capacity - 1 }
+		{
+			for (std::size_t i = 0; i < m_capacity; ++i)
+			{
+				m_slots[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+		mpmc_ring_buffer(const mpmc_ring_buffer&) = delete;
+		mpmc_ring_buffer& operator=(const mpmc_ring_buffer&) = delete;
+
+		std::size_t capacity() const noexcept { return m_capacity; }
+
+		template <typename U>
+		bool try_push(U&& value)
+		{
+			std::size_t tail = m_tail.load(std::memory_order_relaxed);
+			while (true)
+			{
+				Slot& slot = m_slots[tail & m_mask];
+				const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+				const auto diff = static_cast<std::ptrdiff_t>(sequence - tail);
+				if (diff == 0)
+				{
+					if (m_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+					{
+						slot.value = std::forward<U>(value);
+						slot.sequence.store(tail + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0)
+				{
+					// The slot still holds a value from the last lap: full.
+					return false;
+				}
+				else
+				{
+					tail = m_tail.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		std::optional<T> try_pop()
+		{
+			std::size_t head = m_head.load(std::memory_order_relaxed);
+			while (true)
+			{
+				Slot& slot = m_slots[head & m_mask];
+				const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+				const auto diff = static_cast<std::ptrdiff_t>(sequence - (head + 1));
+				if (diff == 0)
+				{
+					if (m_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed))
+					{
+						std::optional<T> result{ std::move(slot.value) };
+						slot.sequence.store(head + m_capacity, std::memory_order_release);
+						return result;
+					}
+				}
+				else if (diff < 0)
+				{
+					// Nothing has been written to this slot yet: empty.
+					return std::nullopt;
+				}
+				else
+				{
+					head = m_head.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		template <typename U>
+		void push(U&& value)
+		{
+			while (!try_push(std::forward<U>(value)))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		T pop()
+		{
+			while (true)
+			{
+				if (auto result = try_pop())
+				{
+					return std::move(*result);
+				}
+				std::this_thread::yield();
+			}
+		}
+	};
+}
@@ -3,6 +3,7 @@
 #include "int_range.h"
 #include "in_range.h"
 #include "push_back_unique.h"
+#include "neighbour_offsets.h"
 
 #include <array>
 #include <vector>
@@ -15,6 +16,15 @@
 namespace utils
 {
 
+	// full re-examines every active cell and its neighbours on each tick.
+	// incremental only re-examines cells which changed on the previous tick, and their neighbours,
+	// and keeps neighbour counts up to date by applying deltas as cells change.
+	enum class conway_tick_mode : char
+	{
+		full,
+		incremental
+	};
+
 	template <std::size_t DIM>
 	class conway_simulation
 	{
@@ -30,9 +40,10 @@ namespace utils
 		Space m_space;
 		std::pair<std::size_t, std::size_t> turn_on_range;
 		std::pair<std::size_t, std::size_t> stay_on_range;
-		mutable std::map<Coord, PointData> m_neighbour_cache;
 		mutable std::map<Coord, std::size_t> m_num_active_neighbours_cache;
 		mutable bool m_sorted = false;
+		conway_tick_mode m_tick_mode;
+		PointData m_changed_points; // Only used in incremental mode.
 
 		static bool verify_bounds(const Bounds& bound, CoordType val)
 		{
@@ -47,9 +58,10 @@ namespace utils
 			return true;
 		}
 
-		static void plus_equal(Coord& left, const Coord& right)
+		// Plain loops rather than int_range in the per-neighbour functions, so they unroll.
+		static void plus_equal(Coord& left, const Coord& right) noexcept
 		{
-			for (auto i : int_range(DIM))
+			for (std::size_t i = 0; i < DIM; ++i)
 			{
 				left[i] += right[i];
 			}
@@ -62,77 +74,56 @@ namespace utils
 			return result;
 		}
 
-		void create_options(PointData& result, const Coord& center, Coord& base, std::size_t index) const
+		bool in_space(const Coord& coord) const noexcept
 		{
-			if (index == DIM)
+			for (std::size_t i = 0; i < DIM; ++i)
 			{
-				if (std::all_of(begin(base), end(base), [](CoordType v) {return v == 0; }))
+				if (!verify_bounds(m_space[i], coord[i]))
 				{
-					return;
+					return false;
 				}
-				const Coord new_coord = plus(center, base);
-				result.push_back(new_coord);
-				return;
 			}
+			return true;
+		}
 
-			for (CoordType i : int_range(-1, 2))
+		// Calls func on every neighbour of coord that lies inside the space.
+		template <typename Func>
+		void for_each_neighbour(const Coord& coord, Func func) const
+		{
+			for (const Coord& offset : neighbour_offsets<DIM, CoordType>)
 			{
-				const CoordType dim_value = center[index] + i;
-				const Bounds& bounds = m_space[index];
-				if (verify_bounds(bounds, dim_value))
+				const Coord neighbour = plus(coord, offset);
+				if (in_space(neighbour))
 				{
-					base[index] = i;
-					create_options(result, center, base, index + 1);
+					func(neighbour);
 				}
 			}
 		}
 
-		PointData calculate_neighbours(const Coord& coord) const
+		PointData get_relevant_points(const PointData& points) const
 		{
-			std::size_t new_size = 1;
-			for (auto i : int_range(DIM))
-			{
-				new_size *= 3;
-			}
 			PointData result;
-			result.reserve(new_size - 1);
-			Coord base;
-			create_options(result, coord, base, 0);
-			return result;
-		}
-
-		PointData get_neighbours(const Coord& coord) const
-		{
-			const auto find_result = m_neighbour_cache.find(coord);
-			if (find_result != end(m_neighbour_cache))
+			result.reserve((num_neighbours<DIM>() + 1) * points.size());
+			for (const Coord& coord : points)
 			{
-				return find_result->second;
+				result.push_back(coord);
+				for_each_neighbour(coord, [&result](const Coord& neighbour) {result.push_back(neighbour); });
 			}
-			PointData result = calculate_neighbours(coord);
-			m_neighbour_cache[coord] = result;
+			std::sort(begin(result), end(result));
+			result.erase(std::unique(begin(result), end(result)), end(result));
 			return result;
 		}
 
 		PointData get_all_relevant_points() const
 		{
-			PointData result;
-			for (const Coord& coord : m_active_points)
-			{
-				const auto neighbours = get_neighbours(coord);
-				result.reserve((neighbours.size() + 1) * m_active_points.size());
-				result.push_back(coord);
-				std::copy(begin(neighbours), end(neighbours), std::back_inserter(result));
-			}
-			std::sort(begin(result), end(result));
-			result.erase(std::unique(begin(result), end(result)), end(result));
-			return result;
+			return get_relevant_points(m_active_points);
 		}
 
 		std::size_t calculate_num_active_neighbours(const Coord& coord) const
 		{
-			const auto neighbours = get_neighbours(coord);
-			return std::count_if(begin(neighbours), end(neighbours),
-				[this](const Coord& c) {return is_active(c); });
+			std::size_t result = 0;
+			for_each_neighbour(coord, [this, &result](const Coord& c) {result += is_active(c) ? 1 : 0; });
+			return result;
 		}
 
 		std::size_t get_num_active_neighbours(const Coord& coord) const
@@ -142,6 +133,11 @@ namespace utils
 			{
 				return find_result->second;
 			}
+			else if (m_tick_mode == conway_tick_mode::incremental)
+			{
+				// The cache holds every non-zero count in this mode.
+				return 0;
+			}
 			else
 			{
 				const std::size_t result = calculate_num_active_neighbours(coord);
@@ -157,16 +153,82 @@ namespace utils
 			return in_range(num_active_neighbours, active_range.first, active_range.second);
 		}
 
+		void apply_neighbour_deltas(const Coord& coord, bool activated)
+		{
+			for_each_neighbour(coord, [this, activated](const Coord& neighbour)
+			{
+				if (activated)
+				{
+					++m_num_active_neighbours_cache[neighbour];
+					return;
+				}
+				const auto find_result = m_num_active_neighbours_cache.find(neighbour);
+				assert(find_result != end(m_num_active_neighbours_cache));
+				assert(find_result->second > 0);
+				if (--(find_result->second) == 0)
+				{
+					m_num_active_neighbours_cache.erase(find_result);
+				}
+			});
+		}
+
+		void tick_full()
+		{
+			PointData new_points;
+			const PointData relevant_points = get_all_relevant_points();
+			std::copy_if(begin(relevant_points), end(relevant_points), std::inserter(new_points, begin(new_points)),
+				[this](const Coord& point) {return should_activate_on_tick(point); });
+			m_active_points = std::move(new_points);
+			m_num_active_neighbours_cache.clear();
+			m_sorted = false;
+		}
+
+		void tick_incremental()
+		{
+			// A cell whose own state and whose neighbours' states didn't change last tick can't change now.
+			const PointData relevant_points = get_relevant_points(m_changed_points);
+			PointData flipped_points;
+			std::copy_if(begin(relevant_points), end(relevant_points), std::back_inserter(flipped_points),
+				[this](const Coord& point) {return should_activate_on_tick(point) != is_active(point); });
+
+			// Both ranges are sorted, and every flipped point either joins or leaves the active set.
+			PointData new_points;
+			new_points.reserve(m_active_points.size() + flipped_points.size());
+			std::set_symmetric_difference(begin(m_active_points), end(m_active_points),
+				begin(flipped_points), end(flipped_points), std::back_inserter(new_points));
+
+			for (const Coord& point : flipped_points)
+			{
+				apply_neighbour_deltas(point, !is_active(point));
+			}
+			m_active_points = std::move(new_points);
+			m_changed_points = std::move(flipped_points);
+		}
+
 	public:
 		conway_simulation(PointData active_points,
 			std::size_t turn_on_min, std::size_t turn_on_max,
 			std::size_t stay_on_min, std::size_t stay_on_max,
-			Space bounds = Space{})
+			Space bounds = Space{},
+			conway_tick_mode tick_mode = conway_tick_mode::full)
 			: m_active_points{ std::move(active_points) }
 			, turn_on_range{ std::make_pair(turn_on_min,turn_on_max) }
 			, stay_on_range{ std::make_pair(stay_on_min,stay_on_max) }
 			, m_space{ bounds }
-		{}
+			, m_tick_mode{ tick_mode }
+		{
+			if (m_tick_mode == conway_tick_mode::incremental)
+			{
+				// Treat the starting state as every active point having just been switched on.
+				std::sort(begin(m_active_points), end(m_active_points));
+				m_sorted = true;
+				m_changed_points = m_active_points;
+				for (const Coord& point : m_active_points)
+				{
+					apply_neighbour_deltas(point, true);
+				}
+			}
+		}
 		conway_simulation(const conway_simulation&) = default;
 		conway_simulation(conway_simulation&&) = default;
 		conway_simulation& operator=(const conway_simulation&) = default;
@@ -174,13 +236,18 @@ namespace utils
 
 		void tick()
 		{
-			PointData new_points;
-			const PointData relevant_points = get_all_relevant_points();
-			std::copy_if(begin(relevant_points), end(relevant_points), std::inserter(new_points, begin(new_points)),
-				[this](const Coord& point) {return should_activate_on_tick(point); });
-			m_active_points = std::move(new_points);
-			m_num_active_neighbours_cache.clear();
-			m_sorted = false;
+			switch (m_tick_mode)
+			{
+			case conway_tick_mode::full:
+				tick_full();
+				break;
+			case conway_tick_mode::incremental:
+				tick_incremental();
+				break;
+			default:
+				assert(false);
+				break;
+			}
 		}
 
 		bool is_active(const Coord& point) const noexcept
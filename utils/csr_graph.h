@@ -0,0 +1,138 @@
+#pragma once
+
+// A directed graph with nodes numbered 0 to num_nodes() - 1, stored in compressed sparse row form:
+// every edge in one array, sorted by the node it leaves from, plus where each node's edges start.
+// Once built it can't change, but walking a node's edges is just reading a slice of that array.
+//
+// reversed() gives the same graph with every edge turned around, for questions like "what leads here?".
+
+#include "dense_bitset.h"
+
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <cstddef>
+#include <cassert>
+
+namespace utils
+{
+	template <typename Weight>
+	class csr_graph
+	{
+	public:
+		struct edge
+		{
+			std::size_t target = 0;
+			Weight weight{};
+		};
+
+		struct input_edge
+		{
+			std::size_t source = 0;
+			std::size_t target = 0;
+			Weight weight{};
+		};
+	private:
+		// Node n's edges are m_edges[m_offsets[n], m_offsets[n + 1]).
+		std::vector<std::size_t> m_offsets;
+		std::vector<edge> m_edges;
+	public:
+		csr_graph() : m_offsets(1, 0) {}
+
+		// The edges can be in any order. Edges from the same node keep their order.
+		csr_graph(std::size_t num_nodes, std::span<const input_edge> edges)
+			: m_offsets(num_nodes + 1, 0)
+			, m_edges(edges.size())
+		{
+			for (const input_edge& e : edges)
+			{
+				assert(e.source < num_nodes && e.target < num_nodes);
+				++m_offsets[e.source + 1];
+			}
+			for (std::size_t node = 0; node < num_nodes; ++node)
+			{
+				m_offsets[node + 1] += m_offsets[node];
+			}
+			std::vector<std::size_t> next_slot(begin(m_offsets), end(m_offsets) - 1);
+			for (const input_edge& e : edges)
+			{
+				m_edges[next_slot[e.source]++] = edge{ e.target, e.weight };
+			}
+		}
+
+		std::size_t num_nodes() const noexcept { return m_offsets.size() - 1; }
+		std::size_t num_edges() const noexcept { return m_edges.size(); }
+
+		std::span<const edge> out_edges(std::size_t node) const noexcept
+		{
+			assert(node < num_nodes());
+			return std::span<const edge>{ m_edges.data() + m_offsets[node], m_offsets[node + 1] - m_offsets[node] };
+		}
+
+		csr_graph reversed() const
+		{
+			std::vector<input_edge> edges;
+			edges.reserve(num_edges());
+			for (std::size_t node = 0; node < num_nodes(); ++node)
+			{
+				for (const edge& e : out_edges(node))
+				{
+					edges.push_back(input_edge{ e.target, node, e.weight });
+				}
+			}
+			return csr_graph{ num_nodes(), edges };
+		}
+
+		// Every node that can be reached from start by following one or more edges, found breadth first.
+		dynamic_bitset reachable_from(std::size_t start) const
+		{
+			dynamic_bitset result(num_nodes());
+			// Nodes are visited in the order they're added.
+			std::vector<std::size_t> to_visit{ start };
+			for (std::size_t i = 0; i < to_visit.size(); ++i)
+			{
+				for (const edge& e : out_edges(to_visit[i]))
+				{
+					if (!result.test(e.target))
+					{
+						result.set(e.target);
+						to_visit.push_back(e.target);
+					}
+				}
+			}
+			return result;
+		}
+
+		// Every node comes before all the nodes its edges lead to. The graph must have no cycles.
+		std::vector<std::size_t> topological_order() const
+		{
+			std::vector<std::size_t> num_incoming(num_nodes(), 0);
+			for (const edge& e : m_edges)
+			{
+				++num_incoming[e.target];
+			}
+			std::vector<std::size_t> result;
+			result.reserve(num_nodes());
+			for (std::size_t node = 0; node < num_nodes(); ++node)
+			{
+				if (num_incoming[node] == 0)
+				{
+					result.push_back(node);
+				}
+			}
+			// result doubles as the queue of nodes with nothing left pointing at them.
+			for (std::size_t i = 0; i < result.size(); ++i)
+			{
+				for (const edge& e : out_edges(result[i]))
+				{
+					if (--num_incoming[e.target] == 0)
+					{
+						result.push_back(e.target);
+					}
+				}
+			}
+			assert(result.size() == num_nodes());
+			return result;
+		}
+	};
+}
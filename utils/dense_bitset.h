@@ -0,0 +1,318 @@
+#pragma once
+
+// Sets of small integers (IDs, letters...) stored as bits in 64-bit words.
+// dense_bitset<N> has a fixed size and can be used in constant expressions. dynamic_bitset picks
+// its size at runtime. Set operations work a whole word at a time in simple loops, which
+// the compiler can vectorize for wide sets.
+// Unlike std::bitset, these can find and iterate over the set bits without testing every bit.
+
+#include <array>
+#include <vector>
+#include <span>
+#include <bit>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace utils
+{
+	namespace internals
+	{
+		constexpr std::size_t BITSET_WORD_BITS = 64;
+
+		constexpr std::size_t num_bitset_words(std::size_t num_bits) noexcept
+		{
+			return (num_bits + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS;
+		}
+
+		// The bits of the last word that are in use.
+		constexpr uint64_t last_word_mask(std::size_t num_bits) noexcept
+		{
+			const std::size_t used = num_bits % BITSET_WORD_BITS;
+			return used == 0 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << used) - 1;
+		}
+
+		constexpr std::size_t popcount_words(const uint64_t* words, std::size_t num_words) noexcept
+		{
+			std::size_t result = 0;
+			for (std::size_t i = 0; i < num_words; ++i)
+			{
+				result += std::popcount(words[i]);
+			}
+			return result;
+		}
+
+		// Returns num_words * 64 if there is no set bit at or after pos.
+		constexpr std::size_t find_next_set_bit(const uint64_t* words, std::size_t num_words, std::size_t pos) noexcept
+		{
+			std::size_t word_idx = pos / BITSET_WORD_BITS;
+			if (word_idx >= num_words)
+			{
+				return num_words * BITSET_WORD_BITS;
+			}
+			uint64_t word = words[word_idx] & (~uint64_t{ 0 } << (pos % BITSET_WORD_BITS));
+			while (word == 0)
+			{
+				if (++word_idx == num_words)
+				{
+					return num_words * BITSET_WORD_BITS;
+				}
+				word = words[word_idx];
+			}
+			return word_idx * BITSET_WORD_BITS + std::countr_zero(word);
+		}
+
+		template <typename Func>
+		constexpr void for_each_set_bit(const uint64_t* words, std::size_t num_words, Func&& func)
+		{
+			for (std::size_t i = 0; i < num_words; ++i)
+			{
+				uint64_t word = words[i];
+				while (word != 0)
+				{
+					func(i * BITSET_WORD_BITS + std::countr_zero(word));
+					word &= word - 1;
+				}
+			}
+		}
+	}
+
+	template <std::size_t N>
+	class dense_bitset
+	{
+		static constexpr std::size_t NUM_WORDS = internals::num_bitset_words(N);
+		std::array<uint64_t, NUM_WORDS> m_words{};
+
+		static constexpr uint64_t bit(std::size_t idx) noexcept { return uint64_t{ 1 } << (idx % internals::BITSET_WORD_BITS); }
+	public:
+		static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+		constexpr dense_bitset() noexcept = default;
+
+		static constexpr dense_bitset all() noexcept
+		{
+			dense_bitset result;
+			for (auto& word : result.m_words)
+			{
+				word = ~uint64_t{ 0 };
+			}
+			if constexpr (NUM_WORDS > 0)
+			{
+				result.m_words.back() &= internals::last_word_mask(N);
+			}
+			return result;
+		}
+
+		constexpr std::size_t size() const noexcept { return N; }
+
+		constexpr bool test(std::size_t idx) const noexcept
+		{
+			assert(idx < N);
+			return (m_words[idx / internals::BITSET_WORD_BITS] & bit(idx)) != 0;
+		}
+		constexpr bool operator[](std::size_t idx) const noexcept { return test(idx); }
+
+		constexpr dense_bitset& set(std::size_t idx, bool value = true) noexcept
+		{
+			assert(idx < N);
+			uint64_t& word = m_words[idx / internals::BITSET_WORD_BITS];
+			word = value ? (word | bit(idx)) : (word & ~bit(idx));
+			return *this;
+		}
+		constexpr dense_bitset& reset(std::size_t idx) noexcept { return set(idx, false); }
+		constexpr void clear() noexcept { m_words = {}; }
+
+		constexpr dense_bitset& operator&=(const dense_bitset& other) noexcept
+		{
+			for (std::size_t i = 0; i < NUM_WORDS; ++i) m_words[i] &= other.m_words[i];
+			return *this;
+		}
+		constexpr dense_bitset& operator|=(const dense_bitset& other) noexcept
+		{
+			for (std::size_t i = 0; i < NUM_WORDS; ++i) m_words[i] |= other.m_words[i];
+			return *this;
+		}
+		constexpr dense_bitset& operator^=(const dense_bitset& other) noexcept
+		{
+			for (std::size_t i = 0; i < NUM_WORDS; ++i) m_words[i] ^= other.m_words[i];
+			return *this;
+		}
+		// Removes every member of other.
+		constexpr dense_bitset& subtract(const dense_bitset& other) noexcept
+		{
+			for (std::size_t i = 0; i < NUM_WORDS; ++i) m_words[i] &= ~other.m_words[i];
+			return *this;
+		}
+
+		constexpr std::size_t count() const noexcept { return internals::popcount_words(m_words.data(), NUM_WORDS); }
+		constexpr bool none() const noexcept
+		{
+			for (uint64_t word : m_words)
+			{
+				if (word != 0) return false;
+			}
+			return true;
+		}
+		constexpr bool any() const noexcept { return !none(); }
+
+		// These return npos if there are no more set bits.
+		constexpr std::size_t find_first() const noexcept { return find_next(0); }
+		constexpr std::size_t find_next(std::size_t pos) const noexcept
+		{
+			const std::size_t result = internals::find_next_set_bit(m_words.data(), NUM_WORDS, pos);
+			return result < N ? result : npos;
+		}
+
+		// Calls func with the index of each set bit, lowest first.
+		template <typename Func>
+		constexpr void for_each_set_bit(Func&& func) const
+		{
+			internals::for_each_set_bit(m_words.data(), NUM_WORDS, func);
+		}
+
+		std::span<const uint64_t> words() const noexcept { return std::span<const uint64_t>{ m_words }; }
+
+		constexpr bool operator==(const dense_bitset&) const noexcept = default;
+	};
+
+	template <std::size_t N>
+	constexpr dense_bitset<N> operator&(dense_bitset<N> left, const dense_bitset<N>& right) noexcept
+	{
+		return left &= right;
+	}
+
+	template <std::size_t N>
+	constexpr dense_bitset<N> operator|(dense_bitset<N> left, const dense_bitset<N>& right) noexcept
+	{
+		return left |= right;
+	}
+
+	template <std::size_t N>
+	constexpr dense_bitset<N> operator^(dense_bitset<N> left, const dense_bitset<N>& right) noexcept
+	{
+		return left ^= right;
+	}
+
+	// Set operations need both sides to be the same size.
+	class dynamic_bitset
+	{
+		std::vector<uint64_t> m_words;
+		std::size_t m_size = 0;
+
+		static uint64_t bit(std::size_t idx) noexcept { return uint64_t{ 1 } << (idx % internals::BITSET_WORD_BITS); }
+	public:
+		static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+		dynamic_bitset() = default;
+		explicit dynamic_bitset(std::size_t size, bool value = false)
+			: m_words(internals::num_bitset_words(size), value ? ~uint64_t{ 0 } : uint64_t{ 0 })
+			, m_size{ size }
+		{
+			if (value && !m_words.empty())
+			{
+				m_words.back() &= internals::last_word_mask(size);
+			}
+		}
+
+		std::size_t size() const noexcept { return m_size; }
+
+		bool test(std::size_t idx) const noexcept
+		{
+			assert(idx < m_size);
+			return (m_words[idx / internals::BITSET_WORD_BITS] & bit(idx)) != 0;
+		}
+		bool operator[](std::size_t idx) const noexcept { return test(idx); }
+
+		dynamic_bitset& set(std::size_t idx, bool value = true) noexcept
+		{
+			assert(idx < m_size);
+			uint64_t& word = m_words[idx / internals::BITSET_WORD_BITS];
+			word = value ? (word | bit(idx)) : (word & ~bit(idx));
+			return *this;
+		}
+		dynamic_bitset& reset(std::size_t idx) noexcept { return set(idx, false); }
+		void clear() noexcept { std::fill(m_words.begin(), m_words.end(), uint64_t{ 0 }); }
+
+		dynamic_bitset& operator&=(const dynamic_bitset& other) noexcept
+		{
+			assert(m_size == other.m_size);
+			for (std::size_t i = 0; i < m_words.size(); ++i) m_words[i] &= other.m_words[i];
+			return *this;
+		}
+		dynamic_bitset& operator|=(const dynamic_bitset& other) noexcept
+		{
+			assert(m_size == other.m_size);
+			for (std::size_t i = 0; i < m_words.size(); ++i) m_words[i] |= other.m_words[i];
+			return *this;
+		}
+		dynamic_bitset& operator^=(const dynamic_bitset& other) noexcept
+		{
+			assert(m_size == other.m_size);
+			for (std::size_t i = 0; i < m_words.size(); ++i) m_words[i] ^= other.m_words[i];
+			return *this;
+		}
+		// Removes every member of other.
+		dynamic_bitset& subtract(const dynamic_bitset& other) noexcept
+		{
+			assert(m_size == other.m_size);
+			for (std::size_t i = 0; i < m_words.size(); ++i) m_words[i] &= ~other.m_words[i];
+			return *this;
+		}
+
+		std::size_t count() const noexcept { return internals::popcount_words(m_words.data(), m_words.size()); }
+		bool none() const noexcept
+		{
+			for (uint64_t word : m_words)
+			{
+				if (word != 0) return false;
+			}
+			return true;
+		}
+		bool any() const noexcept { return !none(); }
+
+		// These return npos if there are no more set bits.
+		std::size_t find_first() const noexcept { return find_next(0); }
+		std::size_t find_next(std::size_t pos) const noexcept
+		{
+			const std::size_t result = internals::find_next_set_bit(m_words.data(), m_words.size(), pos);
+			return result < m_size ? result : npos;
+		}
+
+		// Calls func with the index of each set bit, lowest first.
+		template <typename Func>
+		void for_each_set_bit(Func&& func) const
+		{
+			internals::for_each_set_bit(m_words.data(), m_words.size(), func);
+		}
+
+		std::span<const uint64_t> words() const noexcept { return std::span<const uint64_t>{ m_words }; }
+
+		bool operator==(const dynamic_bitset&) const noexcept = default;
+	};
+
+	inline dynamic_bitset operator&(dynamic_bitset left, const dynamic_bitset& right) noexcept
+	{
+		return left &= right;
+	}
+
+	inline dynamic_bitset operator|(dynamic_bitset left, const dynamic_bitset& right) noexcept
+	{
+		return left |= right;
+	}
+
+	inline dynamic_bitset operator^(dynamic_bitset left, const dynamic_bitset& right) noexcept
+	{
+		return left ^= right;
+	}
+
+	namespace internals
+	{
+		static_assert(dense_bitset<26>::all().count() == 26);
+		static_assert(dense_bitset<64>::all().count() == 64);
+		static_assert(dense_bitset<130>{}.set(3).set(129).find_next(4) == 129);
+		static_assert(dense_bitset<130>{}.set(3).find_next(4) == dense_bitset<130>::npos);
+		static_assert((dense_bitset<70>{}.set(1).set(65) & dense_bitset<70>{}.set(65)).find_first() == 65);
+	}
+}
@@ -0,0 +1,369 @@
+#pragma once
+
+// Open-addressing hash containers. Keys live in one flat array and collisions are resolved by
+// linear probing, so a lookup is a hash, a mask and (usually) a single cache line.
+// Capacity is always a power of two. Erasing uses backward-shift deletion, so there are no tombstones.
+//
+// Unlike std::unordered_map, iterators and references are invalidated by any insertion,
+// and stored values must be default constructible.
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace utils
+{
+	namespace internals
+	{
+		struct flat_hash_identity
+		{
+			template <typename T>
+			const T& operator()(const T& val) const noexcept { return val; }
+		};
+
+		struct flat_hash_first
+		{
+			template <typename Pair>
+			const auto& operator()(const Pair& val) const noexcept { return val.first; }
+		};
+
+		template <typename Key, typename Value, typename KeyOf, typename Hash, typename KeyEqual>
+		class flat_hash_table
+		{
+		public:
+			using key_type = Key;
+			using value_type = Value;
+			using size_type = std::size_t;
+			using hasher = Hash;
+			using key_equal = KeyEqual;
+
+		private:
+			static constexpr std::size_t MIN_CAPACITY = 16;
+			std::vector<Value> m_slots;
+			std::vector<uint8_t> m_used;
+			std::size_t m_size = 0;
+			std::size_t m_mask = 0;
+			Hash m_hash;
+			KeyEqual m_equal;
+
+			template <bool IS_CONST>
+			class basic_iterator
+			{
+				friend class flat_hash_table;
+				using TablePtr = std::conditional_t<IS_CONST, const flat_hash_table*, flat_hash_table*>;
+				TablePtr m_table = nullptr;
+				std::size_t m_idx = 0;
+
+				void skip_empty() noexcept
+				{
+					const std::size_t cap = m_table->m_used.size();
+					while (m_idx < cap && !m_table->m_used[m_idx])
+					{
+						++m_idx;
+					}
+				}
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = Value;
+				using difference_type = std::ptrdiff_t;
+				using pointer = std::conditional_t<IS_CONST, const Value*, Value*>;
+				using reference = std::conditional_t<IS_CONST, const Value&, Value&>;
+
+				basic_iterator() noexcept = default;
+				basic_iterator(TablePtr table, std::size_t idx) noexcept : m_table{ table }, m_idx{ idx } { skip_empty(); }
+				operator basic_iterator<true>() const noexcept { return basic_iterator<true>{ m_table, m_idx }; }
+
+				reference operator*() const noexcept { return m_table->m_slots[m_idx]; }
+				pointer operator->() const noexcept { return &m_table->m_slots[m_idx]; }
+				basic_iterator& operator++() noexcept
+				{
+					++m_idx;
+					skip_empty();
+					return *this;
+				}
+				basic_iterator operator++(int) noexcept
+				{
+					const basic_iterator result = *this;
+					++(*this);
+					return result;
+				}
+				bool operator==(const basic_iterator& other) const noexcept
+				{
+					assert(m_table == other.m_table);
+					return m_idx == other.m_idx;
+				}
+				bool operator!=(const basic_iterator& other) const noexcept { return !(*this == other); }
+			};
+
+			std::size_t home_slot(const Key& key) const noexcept
+			{
+				return m_hash(key) & m_mask;
+			}
+
+			// Returns the slot holding the key, or the empty slot it would go in.
+			template <typename K>
+			std::pair<std::size_t, bool> find_slot(const K& key) const noexcept
+			{
+				assert(!m_used.empty());
+				std::size_t idx = m_hash(key) & m_mask;
+				while (m_used[idx])
+				{
+					if (m_equal(KeyOf{}(m_slots[idx]), key))
+					{
+						return std::make_pair(idx, true);
+					}
+					idx = (idx + 1) & m_mask;
+				}
+				return std::make_pair(idx, false);
+			}
+
+			static std::size_t capacity_for(std::size_t num_elements) noexcept
+			{
+				std::size_t result = MIN_CAPACITY;
+				// Keep the load factor at or below 3/4.
+				while (result * 3 < num_elements * 4)
+				{
+					result *= 2;
+				}
+				return result;
+			}
+
+			void rehash(std::size_t new_capacity)
+			{
+				assert((new_capacity & (new_capacity - 1)) == 0);
+				std::vector<Value> old_slots(new_capacity);
+				std::vector<uint8_t> old_used(new_capacity, 0);
+				old_slots.swap(m_slots);
+				old_used.swap(m_used);
+				m_mask = new_capacity - 1;
+				for (std::size_t i = 0; i < old_used.size(); ++i)
+				{
+					if (old_used[i])
+					{
+						const std::size_t idx = find_slot(KeyOf{}(old_slots[i])).first;
+						m_slots[idx] = std::move(old_slots[i]);
+						m_used[idx] = 1;
+					}
+				}
+			}
+
+			void grow_if_needed()
+			{
+				if (m_used.empty() || (m_size + 1) * 4 > m_used.size() * 3)
+				{
+					rehash(capacity_for(m_size + 1));
+				}
+			}
+
+			void erase_at(std::size_t idx) noexcept
+			{
+				assert(m_used[idx]);
+				m_used[idx] = 0;
+				--m_size;
+				// Backward shift: pull later members of the probe chain into the gap.
+				std::size_t gap = idx;
+				std::size_t next = (idx + 1) & m_mask;
+				while (m_used[next])
+				{
+					const std::size_t home = home_slot(KeyOf{}(m_slots[next]));
+					const bool can_move = (gap <= next) ? (home <= gap || home > next) : (home <= gap && home > next);
+					if (can_move)
+					{
+						m_slots[gap] = std::move(m_slots[next]);
+						m_used[gap] = 1;
+						m_used[next] = 0;
+						gap = next;
+					}
+					next = (next + 1) & m_mask;
+				}
+			}
+
+		protected:
+			// Returns the slot for the key, and whether it was newly claimed.
+			// A newly claimed slot must be filled in by the caller.
+			std::pair<std::size_t, bool> claim_slot(const Key& key)
+			{
+				grow_if_needed();
+				const auto [idx, found] = find_slot(key);
+				if (!found)
+				{
+					m_used[idx] = 1;
+					++m_size;
+				}
+				return std::make_pair(idx, !found);
+			}
+
+			Value& slot(std::size_t idx) noexcept { return m_slots[idx]; }
+
+		public:
+			using iterator = basic_iterator<false>;
+			using const_iterator = basic_iterator<true>;
+
+			flat_hash_table() = default;
+			explicit flat_hash_table(std::size_t expected_size) { reserve(expected_size); }
+			flat_hash_table(const flat_hash_table&) = default;
+			flat_hash_table(flat_hash_table&&) noexcept = default;
+			flat_hash_table& operator=(const flat_hash_table&) = default;
+			flat_hash_table& operator=(flat_hash_table&&) noexcept = default;
+
+			std::size_t size() const noexcept { return m_size; }
+			bool empty() const noexcept { return m_size == 0; }
+			std::size_t capacity() const noexcept { return m_used.size(); }
+
+			void reserve(std::size_t num_elements)
+			{
+				const std::size_t new_capacity = capacity_for(num_elements);
+				if (new_capacity > m_used.size())
+				{
+					rehash(new_capacity);
+				}
+			}
+
+			// Removes all elements but keeps the allocated capacity.
+			void clear() noexcept
+			{
+				std::fill(m_used.begin(), m_used.end(), uint8_t{ 0 });
+				m_size = 0;
+			}
+
+			std::pair<iterator, bool> insert(const Value& value)
+			{
+				const auto [idx, inserted] = claim_slot(KeyOf{}(value));
+				if (inserted)
+				{
+					m_slots[idx] = value;
+				}
+				return std::make_pair(iterator{ this,idx }, inserted);
+			}
+
+			std::pair<iterator, bool> insert(Value&& value)
+			{
+				const auto [idx, inserted] = claim_slot(KeyOf{}(value));
+				if (inserted)
+				{
+					m_slots[idx] = std::move(value);
+				}
+				return std::make_pair(iterator{ this,idx }, inserted);
+			}
+
+			template <typename InputIt>
+			void insert(InputIt first, InputIt last)
+			{
+				for (; first != last; ++first)
+				{
+					insert(*first);
+				}
+			}
+
+			iterator find(const Key& key) noexcept
+			{
+				if (m_size == 0) return end();
+				const auto [idx, found] = find_slot(key);
+				return found ? iterator{ this,idx } : end();
+			}
+
+			const_iterator find(const Key& key) const noexcept
+			{
+				if (m_size == 0) return end();
+				const auto [idx, found] = find_slot(key);
+				return found ? const_iterator{ this,idx } : end();
+			}
+
+			bool contains(const Key& key) const noexcept
+			{
+				return m_size != 0 && find_slot(key).second;
+			}
+
+			std::size_t count(const Key& key) const noexcept
+			{
+				return contains(key) ? 1 : 0;
+			}
+
+			std::size_t erase(const Key& key) noexcept
+			{
+				if (m_size == 0) return 0;
+				const auto [idx, found] = find_slot(key);
+				if (!found) return 0;
+				erase_at(idx);
+				return 1;
+			}
+
+			// Unlike the std containers this does not return the next iterator:
+			// backward-shift deletion may move an unvisited element into this slot.
+			void erase(const_iterator pos) noexcept
+			{
+				assert(pos.m_table == this);
+				erase_at(pos.m_idx);
+			}
+
+			iterator begin() noexcept { return iterator{ this,0 }; }
+			iterator end() noexcept { return iterator{ this,m_used.size() }; }
+			const_iterator begin() const noexcept { return const_iterator{ this,0 }; }
+			const_iterator end() const noexcept { return const_iterator{ this,m_used.size() }; }
+			const_iterator cbegin() const noexcept { return begin(); }
+			const_iterator cend() const noexcept { return end(); }
+		};
+	}
+
+	template <typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class flat_hash_set : public internals::flat_hash_table<Key, Key, internals::flat_hash_identity, Hash, KeyEqual>
+	{
+		using Base = internals::flat_hash_table<Key, Key, internals::flat_hash_identity, Hash, KeyEqual>;
+	public:
+		using Base::Base;
+	};
+
+	template <typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class flat_hash_map : public internals::flat_hash_table<Key, std::pair<Key, T>, internals::flat_hash_first, Hash, KeyEqual>
+	{
+		using Base = internals::flat_hash_table<Key, std::pair<Key, T>, internals::flat_hash_first, Hash, KeyEqual>;
+	public:
+		using mapped_type = T;
+		using typename Base::iterator;
+		using typename Base::const_iterator;
+		using Base::Base;
+
+		template <typename... Args>
+		std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+		{
+			const auto [idx, inserted] = Base::claim_slot(key);
+			if (inserted)
+			{
+				Base::slot(idx) = std::pair<Key, T>{ key, T(std::forward<Args>(args)...) };
+			}
+			return std::make_pair(iterator{ this,idx }, inserted);
+		}
+
+		T& operator[](const Key& key)
+		{
+			const auto [idx, inserted] = Base::claim_slot(key);
+			auto& result = Base::slot(idx);
+			if (inserted)
+			{
+				result.first = key;
+				result.second = T{};
+			}
+			return result.second;
+		}
+
+		T& at(const Key& key) noexcept
+		{
+			const auto it = Base::find(key);
+			assert(it != Base::end());
+			return it->second;
+		}
+
+		const T& at(const Key& key) const noexcept
+		{
+			const auto it = Base::find(key);
+			assert(it != Base::end());
+			return it->second;
+		}
+	};
+}
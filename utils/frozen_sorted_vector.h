@@ -0,0 +1,155 @@
+#pragma once
+
+// A read-only copy of a sorted_vector, laid out for fast lookups.
+// Elements are stored in Eytzinger (breadth-first binary tree) order: the root at index 1,
+// and the children of k at 2k and 2k+1. The first few levels of the tree share a handful of
+// cache lines, and the search is branchless, so lookups in large sets are much faster than
+// std::lower_bound. The catch is that the elements can't be iterated in order or modified.
+
+#include "sorted_vector.h"
+
+#include <vector>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <algorithm>
+#include <cassert>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace utils
+{
+	namespace internals
+	{
+		inline void prefetch(const void* address) noexcept
+		{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+			_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#elif defined(__GNUC__)
+			__builtin_prefetch(address);
+#else
+			(void)address;
+#endif
+		}
+	}
+
+	template <typename T, typename Compare = std::less<T>>
+	class frozen_sorted_vector
+	{
+	public:
+		using value_type = T;
+		using const_pointer = const T*;
+	private:
+		static constexpr std::size_t CACHE_LINE_SIZE = 64;
+		static constexpr std::size_t ELEMENTS_PER_LINE = std::max<std::size_t>(1, CACHE_LINE_SIZE / sizeof(T));
+
+		// Index 0 is unused. Extra slots are allocated so that index 0 can be placed on a cache
+		// line boundary, which puts the 16 great-great-grandchildren of a node (for 4-byte types) on one line.
+		std::vector<T> m_storage;
+		std::size_t m_offset = 0;
+		const T* m_data = nullptr;
+		std::size_t m_size = 0;
+		Compare m_compare;
+
+		template <typename InputIt>
+		void build(InputIt& it, std::size_t k)
+		{
+			if (k > m_size)
+			{
+				return;
+			}
+			build(it, 2 * k);
+			m_storage[index_of(k)] = *it;
+			++it;
+			build(it, 2 * k + 1);
+		}
+
+		std::size_t index_of(std::size_t k) const noexcept
+		{
+			return m_offset + k;
+		}
+
+		template <typename K>
+		std::size_t lower_bound_index(const K& key) const noexcept
+		{
+			std::size_t k = 1;
+			while (k <= m_size)
+			{
+				// Fetch the line holding the descendants four levels down. This may point past the
+				// end, which is harmless for a prefetch, so use integer arithmetic to get there.
+				const auto ahead = reinterpret_cast<std::uintptr_t>(m_data) + k * ELEMENTS_PER_LINE * sizeof(T);
+				internals::prefetch(reinterpret_cast<const void*>(ahead));
+				k = 2 * k + static_cast<std::size_t>(m_compare(m_data[k], key));
+			}
+			// Undo the right turns taken after the last left turn. 0 means every element is less than key.
+			k >>= std::countr_one(k) + 1;
+			return k;
+		}
+
+	public:
+		explicit frozen_sorted_vector(const sorted_vector<T, Compare>& source)
+			: m_size{ source.size() }
+			, m_compare{ source.key_comp() }
+		{
+			m_storage.resize(m_size + 1 + ELEMENTS_PER_LINE);
+			if constexpr (CACHE_LINE_SIZE % sizeof(T) == 0)
+			{
+				const auto address = reinterpret_cast<std::uintptr_t>(m_storage.data());
+				const auto misalignment = address % CACHE_LINE_SIZE;
+				if (misalignment % sizeof(T) == 0 && misalignment != 0)
+				{
+					m_offset = (CACHE_LINE_SIZE - misalignment) / sizeof(T);
+				}
+			}
+			m_data = m_storage.data() + m_offset;
+			auto it = source.cbegin();
+			build(it, 1);
+			assert(it == source.cend());
+		}
+
+		frozen_sorted_vector(const frozen_sorted_vector& other)
+			: m_storage{ other.m_storage }
+			, m_offset{ other.m_offset }
+			, m_data{ m_storage.data() + other.m_offset }
+			, m_size{ other.m_size }
+			, m_compare{ other.m_compare }
+		{
+			// The copy may be aligned differently, but that only affects speed.
+		}
+		frozen_sorted_vector(frozen_sorted_vector&&) noexcept = default;
+		frozen_sorted_vector& operator=(const frozen_sorted_vector& other)
+		{
+			*this = frozen_sorted_vector{ other };
+			return *this;
+		}
+		frozen_sorted_vector& operator=(frozen_sorted_vector&&) noexcept = default;
+
+		std::size_t size() const noexcept { return m_size; }
+		bool empty() const noexcept { return m_size == 0; }
+
+		// Returns the first element not less than key, or nullptr if there isn't one.
+		template <typename K>
+		const T* lower_bound(const K& key) const noexcept
+		{
+			const std::size_t k = lower_bound_index(key);
+			return k != 0 ? m_data + k : nullptr;
+		}
+
+		// Returns an element equivalent to key, or nullptr if there isn't one.
+		template <typename K>
+		const T* find(const K& key) const noexcept
+		{
+			const T* result = lower_bound(key);
+			return (result != nullptr && !m_compare(key, *result)) ? result : nullptr;
+		}
+
+		template <typename K>
+		bool contains(const K& key) const noexcept
+		{
+			return find(key) != nullptr;
+		}
+	};
+}
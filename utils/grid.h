@@ -0,0 +1,299 @@
+#pragma once
+
+// Dense 2D grids, stored row by row in one block.
+// grid<T> can have a border of padding cells on every side. Those cells have coordinates
+// just outside [0,width) and [0,height), so code that looks at neighbours doesn't need bounds
+// checks as long as it stays within the border.
+// oriented_view shows a grid rotated and/or flipped without copying it.
+// bitgrid stores one bit per cell, with each row packed into 64-bit words.
+
+#include "Coords.h"
+#include "index_iterator2.h"
+
+#include <vector>
+#include <array>
+#include <span>
+#include <bit>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace utils
+{
+	// A run of cells a fixed distance apart, such as a column of a grid.
+	// Copying the view doesn't copy the cells.
+	template <typename T>
+	class strided_view
+	{
+		T* m_first = nullptr;
+		std::size_t m_size = 0;
+		std::ptrdiff_t m_stride = 0;
+	public:
+		using value_type = std::remove_const_t<T>;
+		using iterator = std::conditional_t<std::is_const_v<T>, const_index_iterator2<strided_view>, index_iterator2<strided_view>>;
+
+		strided_view() noexcept = default;
+		strided_view(T* first, std::size_t size, std::ptrdiff_t stride) noexcept : m_first{ first }, m_size{ size }, m_stride{ stride } {}
+
+		T& operator[](std::size_t i) const noexcept
+		{
+			assert(i < m_size);
+			return *(m_first + static_cast<std::ptrdiff_t>(i) * m_stride);
+		}
+		std::size_t size() const noexcept { return m_size; }
+		bool empty() const noexcept { return m_size == 0; }
+		iterator begin() const { return iterator{ *this,0 }; }
+		iterator end() const { return iterator{ *this,m_size }; }
+	};
+
+	template <typename T>
+	class grid
+	{
+		std::vector<T> m_cells;
+		int m_width = 0;
+		int m_height = 0;
+		int m_padding = 0;
+		std::ptrdiff_t m_stride = 0;
+		std::size_t m_origin = 0;
+
+		bool in_padded_bounds(int x, int y) const noexcept
+		{
+			return -m_padding <= x && x < m_width + m_padding && -m_padding <= y && y < m_height + m_padding;
+		}
+	public:
+		using value_type = T;
+
+		grid() = default;
+		grid(int width, int height, const T& initial_value = T{}, int padding = 0)
+			: m_width{ width }
+			, m_height{ height }
+			, m_padding{ padding }
+			, m_stride{ width + 2 * padding }
+		{
+			assert(width >= 0 && height >= 0 && padding >= 0);
+			m_cells.resize(static_cast<std::size_t>(m_stride) * (height + 2 * padding), initial_value);
+			m_origin = static_cast<std::size_t>(padding * m_stride + padding);
+		}
+		grid(const grid&) = default;
+		grid(grid&&) noexcept = default;
+		grid& operator=(const grid&) = default;
+		grid& operator=(grid&&) noexcept = default;
+		bool operator==(const grid&) const = default;
+
+		int width() const noexcept { return m_width; }
+		int height() const noexcept { return m_height; }
+		int padding() const noexcept { return m_padding; }
+
+		// The difference between the indices of vertically adjacent cells. Use with
+		// make_linear_neighbour_deltas<2>({ 1, stride() }) to step to neighbours by index.
+		std::ptrdiff_t stride() const noexcept { return m_stride; }
+
+		// Indices cover the padding too, so they are not 0 to width*height.
+		std::size_t index_of(int x, int y) const noexcept
+		{
+			assert(in_padded_bounds(x, y));
+			return static_cast<std::size_t>(static_cast<std::ptrdiff_t>(m_origin) + y * m_stride + x);
+		}
+		std::size_t index_of(const Coords& c) const noexcept { return index_of(c.x, c.y); }
+
+		Coords coords_of(std::size_t index) const noexcept
+		{
+			assert(index < m_cells.size());
+			const auto row = static_cast<int>(index / m_stride);
+			const auto col = static_cast<int>(index % m_stride);
+			return Coords{ col - m_padding, row - m_padding };
+		}
+
+		// Ignores the padding.
+		bool in_bounds(int x, int y) const noexcept
+		{
+			return 0 <= x && x < m_width && 0 <= y && y < m_height;
+		}
+		bool in_bounds(const Coords& c) const noexcept { return in_bounds(c.x, c.y); }
+
+		T& at(int x, int y) noexcept { return m_cells[index_of(x, y)]; }
+		const T& at(int x, int y) const noexcept { return m_cells[index_of(x, y)]; }
+		T& operator[](const Coords& c) noexcept { return at(c.x, c.y); }
+		const T& operator[](const Coords& c) const noexcept { return at(c.x, c.y); }
+		T& cell(std::size_t index) noexcept { return m_cells[index]; }
+		const T& cell(std::size_t index) const noexcept { return m_cells[index]; }
+
+		// Rows and columns don't include the padding.
+		std::span<T> row(int y) noexcept
+		{
+			return std::span<T>{ m_cells.data() + index_of(0, y), static_cast<std::size_t>(m_width) };
+		}
+		std::span<const T> row(int y) const noexcept
+		{
+			return std::span<const T>{ m_cells.data() + index_of(0, y), static_cast<std::size_t>(m_width) };
+		}
+		strided_view<T> column(int x) noexcept
+		{
+			return strided_view<T>{ m_cells.data() + index_of(x, 0), static_cast<std::size_t>(m_height), m_stride };
+		}
+		strided_view<const T> column(int x) const noexcept
+		{
+			return strided_view<const T>{ m_cells.data() + index_of(x, 0), static_cast<std::size_t>(m_height), m_stride };
+		}
+
+		void fill(const T& value)
+		{
+			std::fill(m_cells.begin(), m_cells.end(), value);
+		}
+
+		void fill_padding(const T& value)
+		{
+			for (int y = -m_padding; y < m_height + m_padding; ++y)
+			{
+				const bool inner_row = (0 <= y && y < m_height);
+				for (int x = -m_padding; x < m_width + m_padding; ++x)
+				{
+					if (!inner_row || x < 0 || x >= m_width)
+					{
+						at(x, y) = value;
+					}
+				}
+			}
+		}
+	};
+
+	// One of the eight ways of rotating and flipping a rectangle.
+	// A view coordinate is mapped back to the grid by mirroring first, then transposing.
+	struct grid_orientation
+	{
+		bool transpose = false;
+		bool flip_x = false;
+		bool flip_y = false;
+
+		grid_orientation rotated_clockwise() const noexcept { return grid_orientation{ !transpose, !flip_y, flip_x }; }
+		grid_orientation flipped_horizontally() const noexcept { return grid_orientation{ transpose, !flip_x, flip_y }; }
+		grid_orientation flipped_vertically() const noexcept { return grid_orientation{ transpose, flip_x, !flip_y }; }
+		bool operator==(const grid_orientation&) const noexcept = default;
+	};
+
+	// A rotated and/or flipped window onto a grid. The grid must outlive the view.
+	template <typename Grid>
+	class oriented_view
+	{
+		const Grid* m_grid = nullptr;
+		grid_orientation m_orientation;
+	public:
+		using value_type = typename Grid::value_type;
+
+		oriented_view() noexcept = default;
+		explicit oriented_view(const Grid& g, grid_orientation orientation = grid_orientation{}) noexcept
+			: m_grid{ &g }, m_orientation{ orientation } {}
+
+		int width() const noexcept { return m_orientation.transpose ? m_grid->height() : m_grid->width(); }
+		int height() const noexcept { return m_orientation.transpose ? m_grid->width() : m_grid->height(); }
+		grid_orientation orientation() const noexcept { return m_orientation; }
+
+		Coords to_grid_coords(int x, int y) const noexcept
+		{
+			const int mx = m_orientation.flip_x ? width() - 1 - x : x;
+			const int my = m_orientation.flip_y ? height() - 1 - y : y;
+			return m_orientation.transpose ? Coords{ my, mx } : Coords{ mx, my };
+		}
+
+		bool in_bounds(int x, int y) const noexcept
+		{
+			return 0 <= x && x < width() && 0 <= y && y < height();
+		}
+		bool in_bounds(const Coords& c) const noexcept { return in_bounds(c.x, c.y); }
+
+		decltype(auto) at(int x, int y) const noexcept { return (*m_grid)[to_grid_coords(x, y)]; }
+		decltype(auto) operator[](const Coords& c) const noexcept { return at(c.x, c.y); }
+
+		oriented_view rotated_clockwise() const noexcept { return oriented_view{ *m_grid, m_orientation.rotated_clockwise() }; }
+		oriented_view flipped_horizontally() const noexcept { return oriented_view{ *m_grid, m_orientation.flipped_horizontally() }; }
+		oriented_view flipped_vertically() const noexcept { return oriented_view{ *m_grid, m_orientation.flipped_vertically() }; }
+	};
+
+	// The grid in every orientation: the four rotations, then the four rotations of its mirror image.
+	template <typename Grid>
+	std::array<oriented_view<Grid>, 8> all_orientations(const Grid& g) noexcept
+	{
+		std::array<oriented_view<Grid>, 8> result;
+		result[0] = oriented_view<Grid>{ g };
+		result[4] = result[0].flipped_vertically();
+		for (std::size_t i = 1; i < 4; ++i)
+		{
+			result[i] = result[i - 1].rotated_clockwise();
+			result[i + 4] = result[i + 3].rotated_clockwise();
+		}
+		return result;
+	}
+
+	// One bit per cell. Each row starts on a fresh word, and bits past the width are always 0,
+	// so whole rows can be combined with word operations.
+	class bitgrid
+	{
+		std::vector<uint64_t> m_words;
+		int m_width = 0;
+		int m_height = 0;
+		std::size_t m_words_per_row = 0;
+
+		std::size_t word_index(int x, int y) const noexcept
+		{
+			assert(in_bounds(x, y));
+			return static_cast<std::size_t>(y) * m_words_per_row + static_cast<std::size_t>(x) / 64;
+		}
+		static uint64_t bit(int x) noexcept { return uint64_t{ 1 } << (x % 64); }
+	public:
+		static constexpr int BITS_PER_WORD = 64;
+		using value_type = bool;
+
+		bitgrid() = default;
+		bitgrid(int width, int height)
+			: m_width{ width }
+			, m_height{ height }
+			, m_words_per_row{ (static_cast<std::size_t>(width) + BITS_PER_WORD - 1) / BITS_PER_WORD }
+		{
+			assert(width >= 0 && height >= 0);
+			m_words.resize(m_words_per_row * height, 0);
+		}
+		bool operator==(const bitgrid&) const = default;
+
+		int width() const noexcept { return m_width; }
+		int height() const noexcept { return m_height; }
+		std::size_t words_per_row() const noexcept { return m_words_per_row; }
+
+		bool in_bounds(int x, int y) const noexcept
+		{
+			return 0 <= x && x < m_width && 0 <= y && y < m_height;
+		}
+		bool in_bounds(const Coords& c) const noexcept { return in_bounds(c.x, c.y); }
+
+		bool test(int x, int y) const noexcept { return (m_words[word_index(x, y)] & bit(x)) != 0; }
+		bool operator[](const Coords& c) const noexcept { return test(c.x, c.y); }
+
+		void set(int x, int y, bool value = true) noexcept
+		{
+			uint64_t& word = m_words[word_index(x, y)];
+			word = value ? (word | bit(x)) : (word & ~bit(x));
+		}
+		void reset(int x, int y) noexcept { set(x, y, false); }
+
+		std::span<uint64_t> row(int y) noexcept
+		{
+			assert(0 <= y && y < m_height);
+			return std::span<uint64_t>{ m_words.data() + y * m_words_per_row, m_words_per_row };
+		}
+		std::span<const uint64_t> row(int y) const noexcept
+		{
+			assert(0 <= y && y < m_height);
+			return std::span<const uint64_t>{ m_words.data() + y * m_words_per_row, m_words_per_row };
+		}
+
+		std::size_t count() const noexcept
+		{
+			std::size_t result = 0;
+			for (uint64_t word : m_words)
+			{
+				result += std::popcount(word);
+			}
+			return result;
+		}
+	};
+}
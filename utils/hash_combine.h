@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace utils
+{
+	// Finaliser from splitmix64. Spreads every input bit across the whole output,
+	// which matters for tables that index with a power-of-two mask.
+	constexpr uint64_t hash_mix(uint64_t x) noexcept
+	{
+		x ^= x >> 30;
+		x *= 0xbf58476d1ce4e5b9ULL;
+		x ^= x >> 27;
+		x *= 0x94d049bb133111ebULL;
+		x ^= x >> 31;
+		return x;
+	}
+
+	// Cheap combining step. Call hash_mix on the final result before using it.
+	constexpr uint64_t hash_combine(uint64_t seed, uint64_t value) noexcept
+	{
+		return (seed ^ value) * 0x9e3779b97f4a7c15ULL + (seed >> 29);
+	}
+
+	// Hashes any fixed-size range of integers, such as std::array<int,DIM>.
+	template <typename IntArray>
+	struct int_array_hash
+	{
+		std::size_t operator()(const IntArray& arr) const noexcept
+		{
+			uint64_t result = 0;
+			for (const auto& v : arr)
+			{
+				result = hash_combine(result, static_cast<uint64_t>(static_cast<int64_t>(v)));
+			}
+			return static_cast<std::size_t>(hash_mix(result));
+		}
+	};
+}
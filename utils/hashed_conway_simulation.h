@@ -0,0 +1,153 @@
+#pragma once
+
+// A sparse conway_simulation backend for large or unbounded patterns.
+// Active cells live in an open-addressing hash set. Each tick scatters +1 from every active cell
+// into its neighbours' counts, so only cells next to an active cell are ever touched
+// and nothing needs sorting.
+
+#include "conway_simulation.h"
+#include "flat_hash_map.h"
+#include "hash_combine.h"
+#include "in_range.h"
+#include "neighbour_offsets.h"
+
+#include <array>
+#include <vector>
+#include <optional>
+#include <cassert>
+
+namespace utils
+{
+
+	template <std::size_t DIM>
+	class hashed_conway_simulation
+	{
+	public:
+		using CoordType = typename conway_simulation<DIM>::CoordType;
+		using Coord = typename conway_simulation<DIM>::Coord;
+		using PointData = typename conway_simulation<DIM>::PointData;
+		using Limit = typename conway_simulation<DIM>::Limit;
+		using Bounds = typename conway_simulation<DIM>::Bounds;
+		using Space = typename conway_simulation<DIM>::Space;
+	private:
+		using CoordHash = int_array_hash<Coord>;
+		using ActiveSet = flat_hash_set<Coord, CoordHash>;
+		using CountMap = flat_hash_map<Coord, std::size_t, CoordHash>;
+
+		PointData m_active_points;
+		ActiveSet m_active_set;
+		Space m_space;
+		bool m_bounded;
+		std::pair<std::size_t, std::size_t> turn_on_range;
+		std::pair<std::size_t, std::size_t> stay_on_range;
+
+		// Kept between ticks so the table only allocates while the pattern is growing.
+		CountMap m_num_active_neighbours;
+
+		bool in_space(const Coord& coord) const noexcept
+		{
+			if (!m_bounded)
+			{
+				return true;
+			}
+			for (std::size_t i = 0; i < DIM; ++i)
+			{
+				const Bounds& bounds = m_space[i];
+				if (bounds.first.has_value() && bounds.first.value() > coord[i]) return false;
+				if (bounds.second.has_value() && bounds.second.value() < coord[i]) return false;
+			}
+			return true;
+		}
+
+		void scatter_counts()
+		{
+			m_num_active_neighbours.clear();
+			m_num_active_neighbours.reserve(m_active_points.size() * 4);
+			for (const Coord& coord : m_active_points)
+			{
+				for (const Coord& offset : neighbour_offsets<DIM, CoordType>)
+				{
+					Coord neighbour;
+					for (std::size_t i = 0; i < DIM; ++i)
+					{
+						neighbour[i] = coord[i] + offset[i];
+					}
+					if (in_space(neighbour))
+					{
+						++m_num_active_neighbours[neighbour];
+					}
+				}
+			}
+		}
+
+		void rebuild_active_set()
+		{
+			m_active_set.clear();
+			m_active_set.reserve(m_active_points.size());
+			m_active_set.insert(begin(m_active_points), end(m_active_points));
+		}
+
+	public:
+		hashed_conway_simulation(PointData active_points,
+			std::size_t turn_on_min, std::size_t turn_on_max,
+			std::size_t stay_on_min, std::size_t stay_on_max,
+			Space bounds = Space{})
+			: m_active_points{ std::move(active_points) }
+			, m_space{ bounds }
+			, m_bounded{ std::any_of(begin(bounds), end(bounds),
+				[](const Bounds& b) {return b.first.has_value() || b.second.has_value(); }) }
+			, turn_on_range{ std::make_pair(turn_on_min,turn_on_max) }
+			, stay_on_range{ std::make_pair(stay_on_min,stay_on_max) }
+		{
+			// A dead cell with no live neighbours is never visited, so it can't be allowed to come alive.
+			assert(turn_on_min > 0);
+			rebuild_active_set();
+		}
+		hashed_conway_simulation(const hashed_conway_simulation&) = default;
+		hashed_conway_simulation(hashed_conway_simulation&&) = default;
+		hashed_conway_simulation& operator=(const hashed_conway_simulation&) = default;
+		hashed_conway_simulation& operator=(hashed_conway_simulation&&) = default;
+
+		void tick()
+		{
+			scatter_counts();
+			PointData new_points;
+			new_points.reserve(m_active_points.size());
+			for (const auto& [coord, num_active_neighbours] : m_num_active_neighbours)
+			{
+				const auto& active_range = is_active(coord) ? stay_on_range : turn_on_range;
+				if (in_range(num_active_neighbours, active_range.first, active_range.second))
+				{
+					new_points.push_back(coord);
+				}
+			}
+
+			// Active cells with no active neighbours never received a count.
+			if (stay_on_range.first == 0)
+			{
+				for (const Coord& coord : m_active_points)
+				{
+					if (!m_num_active_neighbours.contains(coord))
+					{
+						new_points.push_back(coord);
+					}
+				}
+			}
+
+			m_active_points = std::move(new_points);
+			rebuild_active_set();
+		}
+
+		bool is_active(const Coord& point) const noexcept
+		{
+			return m_active_set.contains(point);
+		}
+
+		// Unlike conway_simulation, these are not sorted.
+		const PointData& get_active_points() const noexcept
+		{
+			return m_active_points;
+		}
+	};
+
+}
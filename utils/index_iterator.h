@@ -24,13 +24,17 @@ namespace utils
 		}
 	};
 
-	// Container must have operator[] defined, and
-	// a size() method.
-	template <class Container>
-	class index_iterator : public index_iterator_base
+	// Container must have operator[] defined, and a size() method.
+	// A reverse iterator walks the same positions backwards: it starts at the last element
+	// and operator[] counts back from there, like std::reverse_iterator.
+	// operator[] on the container may return by value (as int_range does), in which case reference
+	// isn't a real reference and this isn't strictly a legacy random access iterator. It claims the
+	// legacy random_access_iterator_tag anyway, on purpose: the std::execution algorithms check
+	// iterator_category, and would treat it as an input iterator and refuse it otherwise.
+	// They only read through the iterator, so getting a value rather than a reference is fine.
+	template <class Container, bool REVERSE>
+	class basic_index_iterator : public index_iterator_base
 	{
-	private:
-		static auto get_index_return_type() { return Container{} [0] ; }
 	public:
 		// Traits
 		using difference_type = std::ptrdiff_t;
@@ -38,14 +42,14 @@ namespace utils
 		using pointer = typename Container::pointer_type;
 		using reference = typename Container::reference_type;
 		using iterator_category = std::random_access_iterator_tag;
+		using iterator_concept = std::random_access_iterator_tag;
 
 	private:
+		static constexpr difference_type STEP = REVERSE ? -1 : 1;
 		Container* container = nullptr;
-
-	protected:
 		difference_type pos = 0;
 
-		index_iterator(Container* c, difference_type p) noexcept : container{ c }, pos{ p }{}
+		basic_index_iterator(Container* c, difference_type p) noexcept : container{ c }, pos{ p }{}
 		reference get_from_real_index(difference_type index) const
 		{
 			assert(container != nullptr);
@@ -55,126 +59,83 @@ namespace utils
 		}
 	public:
 		// Constructors
-		index_iterator() noexcept {}
-		index_iterator(const index_iterator&) noexcept = default;
-		index_iterator(index_iterator&&) noexcept = default;
-		index_iterator& operator=(const index_iterator&) noexcept = default;
-		index_iterator& operator=(index_iterator&&) noexcept = default;
+		basic_index_iterator() noexcept {}
+		basic_index_iterator(const basic_index_iterator&) noexcept = default;
+		basic_index_iterator(basic_index_iterator&&) noexcept = default;
+		basic_index_iterator& operator=(const basic_index_iterator&) noexcept = default;
+		basic_index_iterator& operator=(basic_index_iterator&&) noexcept = default;
 
-		static index_iterator begin(Container& c) noexcept { return index_iterator{ &c,0 }; }
-		static index_iterator end(Container& c) noexcept { return index_iterator{ &c,static_cast<difference_type>(c.size()) }; }
+		static basic_index_iterator begin(Container& c) noexcept
+		{
+			return basic_index_iterator{ &c, REVERSE ? static_cast<difference_type>(c.size()) - 1 : 0 };
+		}
+		static basic_index_iterator end(Container& c) noexcept
+		{
+			return basic_index_iterator{ &c, REVERSE ? -1 : static_cast<difference_type>(c.size()) };
+		}
 
 		// Dereference
-		virtual reference operator[](difference_type offset) const
+		reference operator[](difference_type offset) const
 		{
-			return get_from_real_index(pos + offset);
+			return get_from_real_index(pos + offset * STEP);
 		}
 
-		auto operator*() const { return (*this)[0]; }
+		reference operator*() const { return (*this)[0]; }
 
 		// Comparisons
-		std::strong_ordering operator<=>(const index_iterator& other) const noexcept
+		bool operator==(const basic_index_iterator& other) const noexcept
 		{
 			assert(container == other.container);
-			return pos <=> other.pos;
-		}
-		// These aren't defined YET on my impementation
-		bool operator==(const index_iterator& other) const noexcept
-		{
-			return (*this <=> other) == 0;
+			return pos == other.pos;
 		}
-		bool operator!=(const index_iterator& other) const noexcept { return !(*this == other); }
-		bool operator<(const index_iterator& other) const noexcept
+		std::strong_ordering operator<=>(const basic_index_iterator& other) const noexcept
 		{
-			return (*this <=> other) < 0;
+			assert(container == other.container);
+			return pos * STEP <=> other.pos * STEP;
 		}
-		bool operator>(const index_iterator& other) const noexcept { return other < *this; }
-		bool operator<=(const index_iterator& other) const noexcept { return !(*this > other); }
-		bool operator>=(const index_iterator& other) const noexcept { return !(*this < other); }
 
 		// Arithmetic
-		virtual index_iterator& operator+=(difference_type offset) noexcept
+		basic_index_iterator& operator+=(difference_type offset) noexcept
 		{
-			pos += offset;
+			pos += offset * STEP;
 			return *this;
 		}
-		index_iterator& operator-=(difference_type offset) noexcept
+		basic_index_iterator& operator-=(difference_type offset) noexcept
 		{
 			return operator+=(-offset);
 		}
-		index_iterator& operator++(int) noexcept { return operator+=(1); }
-		index_iterator& operator--(int) noexcept { return operator-=(1); }
-		index_iterator operator++() noexcept
+		basic_index_iterator& operator++() noexcept { return operator+=(1); }
+		basic_index_iterator& operator--() noexcept { return operator-=(1); }
+		basic_index_iterator operator++(int) noexcept
 		{
-			const auto res = operator++(0);
+			const auto res = *this;
+			operator++();
 			return res;
 		}
-		index_iterator operator--() noexcept
+		basic_index_iterator operator--(int) noexcept
 		{
-			const auto res = operator--(0);
+			const auto res = *this;
+			operator--();
 			return res;
 		}
-		index_iterator operator+(difference_type offset) const noexcept
-		{
-			auto res = *this;
-			res += offset;
-			return res;
-		}
-		index_iterator operator-(difference_type offset) const noexcept
-		{
-			auto res = *this;
-			res -= offset;
-			return res;
-		}
-		difference_type operator-(index_iterator other) const noexcept
+		friend basic_index_iterator operator+(basic_index_iterator it, difference_type offset) noexcept { return it += offset; }
+		friend basic_index_iterator operator+(difference_type offset, basic_index_iterator it) noexcept { return it += offset; }
+		friend basic_index_iterator operator-(basic_index_iterator it, difference_type offset) noexcept { return it -= offset; }
+		difference_type operator-(const basic_index_iterator& other) const noexcept
 		{
 			assert(container == other.container);
-			return static_cast<difference_type>(pos) - static_cast<difference_type>(other.pos);
+			return (pos - other.pos) * STEP;
 		}
 	};
 
 	template <class Container>
-	using const_index_iterator = index_iterator<const Container>;
+	using index_iterator = basic_index_iterator<Container, false>;
 
 	template <class Container>
-	class reverse_index_iterator : public index_iterator<Container>
-	{
-	public:
-		using Base = index_iterator<Container>;
-		using difference_type = Base::difference_type;
-		using value_type = Base::value_type;
-		using pointer = Base::pointer;
-		using reference = Base::reference;
-		using iterator_category = Base::iterator_category;
-	private:
-		reverse_index_iterator(Container* c, difference_type p) noexcept : Base{ c,p } {}
-		using Base::pos;
-		using Base::get_from_real_index;
-	public:
-		reverse_index_iterator() noexcept : index_iterator{} {}
-		reverse_index_iterator& operator+=(difference_type offset) noexcept override final
-		{
-			pos -= offset;
-			return *this;
-		}
-
-		virtual reference operator[](difference_type offset) const noexcept override final
-		{
-			// This looks weird, but is done to make this act like the standard
-			// reverse iterators when they are converted to reverse ones.
-			return get_from_real_index(pos - offset);
-		}
-
-		static reverse_index_iterator begin(Container& c) noexcept
-		{
-			return reverse_index_iterator{ &c, static_cast<difference_type>(c.size() - 1) };
-		}
+	using const_index_iterator = index_iterator<const Container>;
 
-		static reverse_index_iterator end(Container& c) noexcept
-		{
-			return reverse_index_iterator{ &c,-1 };
-		}
-	};
+	template <class Container>
+	using reverse_index_iterator = basic_index_iterator<Container, true>;
 
 	template <class Container>
 	using const_reverse_index_iterator = reverse_index_iterator<const Container>;
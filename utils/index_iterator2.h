@@ -1,18 +1,32 @@
 #pragma once
 
+// Random access iterators for any container with operator[] and size().
+// These satisfy std::random_access_iterator, so they can be used with the parallel algorithms.
+
 #include <iterator>
+#include <memory>
+#include <compare>
+#include <type_traits>
+#include <cstddef>
 #include <cassert>
 
 namespace utils
 {
 	template <typename Container>
-	class const_index_iterator2 : public std::random_access_iterator_tag
+	class const_index_iterator2
 	{
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using iterator_concept = std::random_access_iterator_tag;
+		using value_type = std::remove_cv_t<typename Container::value_type>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const value_type*;
+		using reference = const value_type&;
 	protected:
 		const Container* container;
-		std::size_t pos;
+		difference_type pos;
 	public:
-		const_index_iterator2(const Container& c, std::size_t initial_pos) : container{ &c }, pos{ initial_pos }{}
+		const_index_iterator2(const Container& c, std::size_t initial_pos) : container{ &c }, pos{ static_cast<difference_type>(initial_pos) }{}
 		const_index_iterator2() : container{ nullptr }, pos{ 0 }{}
 		const_index_iterator2(const const_index_iterator2&) = default;
 		const_index_iterator2(const_index_iterator2&&) = default;
@@ -25,21 +39,23 @@ namespace utils
 			return pos == other.pos;
 		}
 
-		bool operator!=(const const_index_iterator2& other) const
+		std::strong_ordering operator<=>(const const_index_iterator2& other) const
 		{
-			return !(operator==(other));
+			assert(container == other.container);
+			return pos <=> other.pos;
 		}
 
-		std::ptrdiff_t operator-(const const_index_iterator2& other) const
+		difference_type operator-(const const_index_iterator2& other) const
 		{
 			assert(container == other.container);
-			return static_cast<std::ptrdiff_t>(pos) - other.pos;
+			return pos - other.pos;
 		}
 
-		typename const Container::value_type& operator*() const { return (*container)[pos]; }
-		typename const Container::value_type& operator->() const { return (*container)[pos]; }
-		const_index_iterator2& operator+=(int rhs) { pos += rhs; return *this; }
-		const_index_iterator2& operator-=(int rhs) { pos -= rhs; return *this; }
+		reference operator*() const { return (*container)[static_cast<std::size_t>(pos)]; }
+		pointer operator->() const { return std::addressof(**this); }
+		reference operator[](difference_type offset) const { return (*container)[static_cast<std::size_t>(pos + offset)]; }
+		const_index_iterator2& operator+=(difference_type rhs) { pos += rhs; return *this; }
+		const_index_iterator2& operator-=(difference_type rhs) { pos -= rhs; return *this; }
 		const_index_iterator2& operator++() { return (*this) += 1; }
 		const_index_iterator2& operator--() { return (*this) -= 1; }
 		const_index_iterator2 operator++(int)
@@ -54,26 +70,44 @@ namespace utils
 			--(*this);
 			return res;
 		}
+
+		friend const_index_iterator2 operator+(const_index_iterator2 left, difference_type right) { return left += right; }
+		friend const_index_iterator2 operator+(difference_type left, const_index_iterator2 right) { return right += left; }
+		friend const_index_iterator2 operator-(const_index_iterator2 left, difference_type right) { return left -= right; }
 	};
 
 	template <typename Container>
 	class index_iterator2 : public const_index_iterator2<Container>
 	{
 	private:
-		using const_index_iterator2<Container>::container;
-		using const_index_iterator2<Container>::pos;
+		using Base = const_index_iterator2<Container>;
+		using Base::container;
+		using Base::pos;
 	public:
-		index_iterator2(const Container& c, std::size_t initial_pos) : const_index_iterator2<Container>{ c,initial_pos } {}
-		index_iterator2() : const_index_iterator2{} {}
+		using typename Base::iterator_category;
+		using typename Base::iterator_concept;
+		using typename Base::value_type;
+		using typename Base::difference_type;
+		using pointer = value_type*;
+		using reference = value_type&;
+
+		index_iterator2(const Container& c, std::size_t initial_pos) : Base{ c,initial_pos } {}
+		index_iterator2() : Base{} {}
 		index_iterator2(const index_iterator2&) = default;
 		index_iterator2(index_iterator2&&) = default;
 		index_iterator2& operator=(const index_iterator2&) = default;
 		index_iterator2& operator=(index_iterator2&&) = default;
 
-		typename Container::value_type& operator*() const { return (*const_cast<Container*>(container))[pos]; }
-		typename Container::value_type& operator->() const { return (*const_cast<Container*>(container))[pos]; }
-		index_iterator2& operator+=(int rhs) { pos += rhs; return *this; }
-		index_iterator2& operator-=(int rhs) { pos -= rhs; return *this; }
+		// Without these, two index_iterator2s would be compared through a conversion to the base class.
+		bool operator==(const index_iterator2& other) const { return Base::operator==(other); }
+		std::strong_ordering operator<=>(const index_iterator2& other) const { return Base::operator<=>(other); }
+		difference_type operator-(const index_iterator2& other) const { return Base::operator-(other); }
+
+		reference operator*() const { return (*const_cast<Container*>(container))[static_cast<std::size_t>(pos)]; }
+		pointer operator->() const { return std::addressof(**this); }
+		reference operator[](difference_type offset) const { return (*const_cast<Container*>(container))[static_cast<std::size_t>(pos + offset)]; }
+		index_iterator2& operator+=(difference_type rhs) { pos += rhs; return *this; }
+		index_iterator2& operator-=(difference_type rhs) { pos -= rhs; return *this; }
 		index_iterator2& operator++() { return (*this) += 1; }
 		index_iterator2& operator--() { return (*this) -= 1; }
 		index_iterator2 operator++(int)
@@ -88,6 +122,10 @@ namespace utils
 			--(*this);
 			return res;
 		}
+
+		friend index_iterator2 operator+(index_iterator2 left, difference_type right) { return left += right; }
+		friend index_iterator2 operator+(difference_type left, index_iterator2 right) { return right += left; }
+		friend index_iterator2 operator-(index_iterator2 left, difference_type right) { return left -= right; }
 	};
 
 	template <typename Container>
@@ -113,48 +151,16 @@ namespace utils
 	{
 		return make_idx_it_cend(c);
 	}
-	
+
 	template <typename Container>
 	inline index_iterator2<Container> make_idx_it_begin(Container& c)
 	{
 		return index_iterator2{ c,0 };
 	}
-	
+
 	template <typename Container>
 	inline index_iterator2<Container> make_idx_it_end(Container& c)
 	{
 		return index_iterator2{ c,c.size() };
 	}
 }
-
-template <typename Container>
-utils::const_index_iterator2<Container> operator+(const utils::const_index_iterator2<Container>& left, int right)
-{
-	auto result = left;
-	result += right;
-	return result;
-}
-
-template <typename Container>
-utils::const_index_iterator2<Container> operator-(const utils::const_index_iterator2<Container>& left, int right)
-{
-	auto result = left;
-	result -= right;
-	return result;
-}
-
-template <typename Container>
-utils::index_iterator2<Container> operator+(const utils::index_iterator2<Container>& left, int right)
-{
-	auto result = left;
-	result += right;
-	return result;
-}
-
-template <typename Container>
-utils::index_iterator2<Container> operator-(const utils::index_iterator2<Container>& left, int right)
-{
-	auto result = left;
-	result -= right;
-	return result;
-}
@@ -71,4 +71,7 @@ namespace utils
 		INDEX_ITERATOR_MEMBER_BOILERPLATE_CONST(int_range<INT>)
 	};
 
+	static_assert(std::random_access_iterator<int_range<int>::iterator>);
+	static_assert(std::random_access_iterator<int_range<std::size_t>::reverse_iterator>);
+
 }
@@ -0,0 +1,151 @@
+#pragma once
+
+// Maps strings to small dense IDs (0, 1, 2...) in the order they are first seen, and back again.
+// The characters are copied into an arena of fixed-size blocks, so the string_views handed out
+// stay valid for as long as the interner exists, even as more strings are added.
+//
+// concurrent_interner can be used from several threads at once. Lookups of strings that are
+// already interned only take a shared lock.
+
+#include "flat_hash_map.h"
+
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <mutex>
+#include <shared_mutex>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace utils
+{
+	namespace internals
+	{
+		class string_arena
+		{
+			static constexpr std::size_t BLOCK_SIZE = 4096;
+			std::vector<std::unique_ptr<char[]>> m_blocks;
+			char* m_current = nullptr;
+			std::size_t m_remaining = 0;
+		public:
+			std::string_view store(std::string_view str)
+			{
+				if (str.empty())
+				{
+					return std::string_view{};
+				}
+				// Big strings get their own block so they don't waste the rest of the current one.
+				if (str.size() > BLOCK_SIZE / 4)
+				{
+					m_blocks.push_back(std::make_unique<char[]>(str.size()));
+					std::copy(begin(str), end(str), m_blocks.back().get());
+					return std::string_view{ m_blocks.back().get(), str.size() };
+				}
+				if (str.size() > m_remaining)
+				{
+					m_blocks.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+					m_current = m_blocks.back().get();
+					m_remaining = BLOCK_SIZE;
+				}
+				char* const result = m_current;
+				std::copy(begin(str), end(str), result);
+				m_current += str.size();
+				m_remaining -= str.size();
+				return std::string_view{ result, str.size() };
+			}
+		};
+
+		struct null_mutex
+		{
+			void lock() noexcept {}
+			void unlock() noexcept {}
+			void lock_shared() noexcept {}
+			void unlock_shared() noexcept {}
+		};
+	}
+
+	template <bool CONCURRENT>
+	class basic_interner
+	{
+	public:
+		using id_type = uint32_t;
+	private:
+		using Mutex = std::conditional_t<CONCURRENT, std::shared_mutex, internals::null_mutex>;
+		internals::string_arena m_arena;
+		std::vector<std::string_view> m_strings;
+		flat_hash_map<std::string_view, id_type> m_ids;
+		mutable Mutex m_mutex;
+
+		std::optional<id_type> find_unlocked(std::string_view str) const noexcept
+		{
+			const auto it = m_ids.find(str);
+			return it != m_ids.end() ? std::optional<id_type>{ it->second } : std::nullopt;
+		}
+	public:
+		basic_interner() = default;
+		basic_interner(basic_interner&&) = default;
+		basic_interner& operator=(basic_interner&&) = default;
+
+		// Returns the ID for the string, adding it if it hasn't been seen before.
+		id_type intern(std::string_view str)
+		{
+			if constexpr (CONCURRENT)
+			{
+				std::shared_lock lock{ m_mutex };
+				if (const auto result = find_unlocked(str))
+				{
+					return *result;
+				}
+			}
+			std::unique_lock lock{ m_mutex };
+			// In concurrent mode another thread may have added it since the check above.
+			if (const auto result = find_unlocked(str))
+			{
+				return *result;
+			}
+			const auto id = static_cast<id_type>(m_strings.size());
+			const std::string_view stored = m_arena.store(str);
+			m_strings.push_back(stored);
+			m_ids.try_emplace(stored, id);
+			return id;
+		}
+
+		// Returns the ID for the string if it has been interned, without adding it.
+		std::optional<id_type> find(std::string_view str) const
+		{
+			std::shared_lock lock{ m_mutex };
+			return find_unlocked(str);
+		}
+
+		bool contains(std::string_view str) const
+		{
+			return find(str).has_value();
+		}
+
+		std::string_view operator[](id_type id) const
+		{
+			std::shared_lock lock{ m_mutex };
+			assert(id < m_strings.size());
+			return m_strings[id];
+		}
+
+		std::size_t size() const
+		{
+			std::shared_lock lock{ m_mutex };
+			return m_strings.size();
+		}
+
+		void reserve(std::size_t num_strings)
+		{
+			std::unique_lock lock{ m_mutex };
+			m_strings.reserve(num_strings);
+			m_ids.reserve(num_strings);
+		}
+	};
+
+	using interner = basic_interner<false>;
+	using concurrent_interner = basic_interner<true>;
+}
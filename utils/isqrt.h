@@ -1,62 +1,95 @@
 #pragma once
 
 // This feels like something you should find in the standard library, but all the square root functions there return doubles.
-// So I did this to avoid any possible problems with precision.
+// At run time this takes the double estimate and corrects it, which is always exact for 64-bit inputs: the estimate is never out by more than one.
+// In constant expressions (where std::sqrt can't be used) it works a bit at a time instead.
 
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <type_traits>
 
 namespace utils
 {
 	namespace internals
 	{
-		inline uint32_t isqrt_implementation(uint32_t guess_base, uint32_t input)
+		// Finds one bit of the result per step, from the top. Always 32 steps, with no branches.
+		constexpr uint64_t isqrt_bitwise(uint64_t input) noexcept
 		{
-			assert(input > 0);
-			uint64_t guess = 1;
-			while (true)
+			uint64_t remainder = input;
+			uint64_t result = 0;
+			for (uint64_t bit = uint64_t{ 1 } << 62; bit != 0; bit >>= 2)
 			{
-				auto sqr = [](uint64_t x) -> uint64_t {return x * x; };
-				const uint64_t trial_result = guess_base + guess;
-				const uint64_t trial_square = sqr(trial_result);
-				if (trial_square == input) // Perfect match!
-				{
-					return static_cast<int32_t>(trial_result);
-				}
-				else if(trial_square < input) // Too small. Try a bigger number.
-				{
-					guess *= 2;
-				}
-				else if(guess == 1) // We have an imperfect result: guess_base is too small, but guess_base+1 is too big
-				{
-					return guess_base;
-				}
-				else // guess > 1 && trial_result is too big.
-				{
-					// Roll the guess back a stage (div by 2) and restart with a better base.
-					return isqrt_implementation(guess_base + static_cast<uint32_t>(guess / 2), input);
-				}
+				const uint64_t trial = result + bit;
+				const uint64_t take = uint64_t{ 0 } - static_cast<uint64_t>(remainder >= trial);
+				remainder -= trial & take;
+				result = (result >> 1) + (bit & take);
 			}
+			return result;
+		}
+
+		inline uint64_t isqrt_estimate(uint64_t input) noexcept
+		{
+			constexpr uint64_t MAX_RESULT = 0xFFFF'FFFF;
+			uint64_t result = static_cast<uint64_t>(std::sqrt(static_cast<double>(input)));
+			result = result > MAX_RESULT ? MAX_RESULT : result;
+			result -= static_cast<uint64_t>(result * result > input);
+			// (result + 1)^2 wraps to 0 when result is MAX_RESULT, so that case is masked out.
+			const bool can_increase = result < MAX_RESULT;
+			result += static_cast<uint64_t>(can_increase & ((result + 1) * (result + 1) <= input));
+			return result;
+		}
+
+		constexpr uint64_t isqrt_implementation(uint64_t input) noexcept
+		{
+			if (std::is_constant_evaluated())
+			{
+				return isqrt_bitwise(input);
+			}
+			return isqrt_estimate(input);
 		}
 	}
 
 	// Return the square root of an integer. If not exact, this is rounded down.
-	// Guaranteed to have no floating point inaccuracies.
-	inline uint32_t isqrt(uint32_t input)
+	constexpr uint32_t isqrt(uint32_t input) noexcept
 	{
-		switch (input)
-		{
-		default:
-			return internals::isqrt_implementation(0, input);
-		case 0:
-			return 0;
-		// Add more common cases here if optimisation is needed.
-		}
+		return static_cast<uint32_t>(internals::isqrt_implementation(input));
 	}
 
-	inline int32_t isqrt(int32_t input)
+	constexpr uint64_t isqrt(uint64_t input) noexcept
+	{
+		return internals::isqrt_implementation(input);
+	}
+
+	constexpr int32_t isqrt(int32_t input) noexcept
 	{
 		assert(input >= 0);
 		return static_cast<int32_t>(isqrt(static_cast<uint32_t>(input)));
 	}
+
+	constexpr int64_t isqrt(int64_t input) noexcept
+	{
+		assert(input >= 0);
+		return static_cast<int64_t>(isqrt(static_cast<uint64_t>(input)));
+	}
+
+	namespace internals
+	{
+		static_assert(isqrt(0u) == 0);
+		static_assert(isqrt(1u) == 1);
+		static_assert(isqrt(3u) == 1);
+		static_assert(isqrt(4u) == 2);
+		static_assert(isqrt(143u) == 11);
+		static_assert(isqrt(144u) == 12);
+		static_assert(isqrt(145u) == 12);
+		static_assert(isqrt(65535u * 65535u - 1) == 65534);
+		static_assert(isqrt(65535u * 65535u) == 65535);
+		static_assert(isqrt(UINT32_MAX) == 65535);
+		static_assert(isqrt(uint64_t{ 0xFFFF'FFFF } * 0xFFFF'FFFF - 1) == 0xFFFF'FFFE);
+		static_assert(isqrt(uint64_t{ 0xFFFF'FFFF } * 0xFFFF'FFFF) == 0xFFFF'FFFF);
+		static_assert(isqrt(UINT64_MAX) == 0xFFFF'FFFF);
+		static_assert(isqrt(uint64_t{ 1 } << 62) == uint64_t{ 1 } << 31);
+		static_assert(isqrt(int32_t{ 144 }) == 12);
+		static_assert(isqrt(int64_t{ 1'000'000'000'000 }) == 1'000'000);
+	}
 }
@@ -0,0 +1,554 @@
+#pragma once
+
+// Finding k values in a list which add up to a target, as in day 1.
+// Each position can only be used once, but equal values at different positions are fine.
+// All but the last few values are picked by brute force over the sorted values, skipping any
+// choice that makes the target unreachable. The strategy decides how the last few are found:
+//  - two_pointer: the last two, walking in from both ends of what's left. No extra memory.
+//  - hash_set: the last one, by looking up what's still needed. O(n) extra memory.
+//  - meet_in_the_middle: the last four, as two pairs from a table of the sums of every pair of
+//    distinct values, built once and sorted by sum. The two pairs are found by walking in from both
+//    ends of the table, like two_pointer. With d distinct values the table has about d^2/2 entries,
+//    so k = 4 takes O(d^2 log d) time, and each extra value multiplies that by n.
+//  - bitmap: the last two, for values in [0, max]. One bit per possible value is set if it's
+//    still available, and b + c = s is checked for 64 values of b at once by ANDing with the
+//    bitmap reversed and shifted. O(max/64) for the last two, so O(n * max/64) for k = 3.
+//
+// The sum of any k values must fit in T.
+//
+// automatic only uses meet_in_the_middle if the table fits in memory_budget bytes, which by default
+// allows about 5,800 values. With more values than that, k >= 4 is brute force down to the last two,
+// which is O(n^(k-1)): fine for a few hundred values, but hopeless for a million. k = 3 is O(n^2)
+// whatever the strategy, unless the values are small enough for bitmap. Targets that can't be
+// reached are the slow case, as nothing is found to stop the search early.
+
+#include "flat_hash_map.h"
+
+#include <vector>
+#include <array>
+#include <optional>
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <concepts>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace utils
+{
+	enum class k_sum_strategy
+	{
+		automatic,
+		two_pointer,
+		hash_set,
+		meet_in_the_middle,
+		bitmap
+	};
+
+	// automatic only uses bitmap when no value is bigger than this.
+	constexpr uint64_t DEFAULT_K_SUM_MAX_BITMAP_VALUE = 1 << 16;
+
+	// automatic only uses meet_in_the_middle when its table of pair sums takes up no more bytes than this.
+	constexpr uint64_t DEFAULT_K_SUM_MEMORY_BUDGET = uint64_t{ 1 } << 28;
+
+	namespace internals
+	{
+		// The sum of the values at two positions in the list of distinct values, with low <= high.
+		template <std::integral T>
+		struct k_sum_pair
+		{
+			T sum;
+			uint32_t low;
+			uint32_t high;
+		};
+
+		// The most the table of pair sums could take up. Equal values share entries, so it's often less.
+		template <std::integral T>
+		constexpr uint64_t k_sum_pair_table_bytes(std::size_t num_values) noexcept
+		{
+			const auto n = static_cast<uint64_t>(num_values);
+			return n * (n + 1) / 2 * sizeof(k_sum_pair<T>);
+		}
+
+		template <std::integral T>
+		class k_sum_solver
+		{
+			std::vector<T> m_sorted;
+			// Where each of m_sorted came from in the input.
+			std::vector<std::size_t> m_original;
+			// Positions in m_sorted picked so far.
+			std::vector<std::size_t> m_chosen;
+			k_sum_strategy m_strategy;
+			// hash_set: the last position in m_sorted of each value.
+			flat_hash_map<T, std::size_t> m_last_position;
+			// meet_in_the_middle: where each distinct value starts in m_sorted, with m_sorted.size() on the end,
+			// and every pair of them that could be picked together, sorted by sum and then by low, highest first.
+			std::vector<std::size_t> m_value_starts;
+			std::vector<k_sum_pair<T>> m_pairs;
+			// bitmap: how many of each value are still available, with a bit set for each non-zero count.
+			// The reversed bitmap has bit (m_max_value - v) set for each available v.
+			std::vector<uint32_t> m_counts;
+			std::vector<uint64_t> m_bits;
+			std::vector<uint64_t> m_reversed_bits;
+			std::size_t m_max_value = 0;
+
+			// The smallest sum of num_values values from first onwards.
+			T smallest_sum(std::size_t first, std::size_t num_values) const
+			{
+				return std::accumulate(begin(m_sorted) + first, begin(m_sorted) + first + num_values, T{ 0 });
+			}
+
+			T largest_sum(std::size_t num_values) const
+			{
+				return std::accumulate(end(m_sorted) - num_values, end(m_sorted), T{ 0 });
+			}
+
+			bool find_one(std::size_t first, T target)
+			{
+				const auto it = std::lower_bound(begin(m_sorted) + first, end(m_sorted), target);
+				if (it == end(m_sorted) || *it != target)
+				{
+					return false;
+				}
+				m_chosen.push_back(static_cast<std::size_t>(it - begin(m_sorted)));
+				return true;
+			}
+
+			bool find_two_pointer(std::size_t first, T target)
+			{
+				if (m_sorted.size() - first < 2)
+				{
+					return false;
+				}
+				std::size_t low = first;
+				std::size_t high = m_sorted.size() - 1;
+				while (low < high)
+				{
+					const T sum = m_sorted[low] + m_sorted[high];
+					if (sum == target)
+					{
+						m_chosen.push_back(low);
+						m_chosen.push_back(high);
+						return true;
+					}
+					if (sum < target)
+					{
+						++low;
+					}
+					else
+					{
+						--high;
+					}
+				}
+				return false;
+			}
+
+			bool find_two_hashed(std::size_t first, T target)
+			{
+				for (std::size_t i = first; i < m_sorted.size(); ++i)
+				{
+					const T needed = target - m_sorted[i];
+					// The partner comes later, so is no smaller.
+					if (needed < m_sorted[i])
+					{
+						return false;
+					}
+					const auto it = m_last_position.find(needed);
+					if (it != m_last_position.end() && it->second > i)
+					{
+						m_chosen.push_back(i);
+						m_chosen.push_back(it->second);
+						return true;
+					}
+				}
+				return false;
+			}
+
+			void set_available(std::size_t value, bool available) noexcept
+			{
+				const std::size_t reversed = m_max_value - value;
+				const uint64_t bit = uint64_t{ 1 } << (value % 64);
+				const uint64_t reversed_bit = uint64_t{ 1 } << (reversed % 64);
+				m_bits[value / 64] = available ? (m_bits[value / 64] | bit) : (m_bits[value / 64] & ~bit);
+				m_reversed_bits[reversed / 64] = available ? (m_reversed_bits[reversed / 64] | reversed_bit) : (m_reversed_bits[reversed / 64] & ~reversed_bit);
+			}
+
+			// The bitmap always holds exactly the positions from first onwards, so solve takes
+			// each position out while trying it, and puts them all back when it's done.
+			void take_out(std::size_t pos) noexcept
+			{
+				if (m_strategy == k_sum_strategy::bitmap)
+				{
+					const auto value = static_cast<std::size_t>(m_sorted[pos]);
+					if (--m_counts[value] == 0)
+					{
+						set_available(value, false);
+					}
+				}
+			}
+
+			void put_back(std::size_t pos) noexcept
+			{
+				if (m_strategy == k_sum_strategy::bitmap)
+				{
+					const auto value = static_cast<std::size_t>(m_sorted[pos]);
+					if (m_counts[value]++ == 0)
+					{
+						set_available(value, true);
+					}
+				}
+			}
+
+			// Bits [first, first + 64) of the reversed bitmap. Bits outside it are 0.
+			uint64_t reversed_word_at(std::ptrdiff_t first) const noexcept
+			{
+				const auto num_bits = static_cast<std::ptrdiff_t>(m_reversed_bits.size() * 64);
+				if (first <= -64 || first >= num_bits)
+				{
+					return 0;
+				}
+				if (first < 0)
+				{
+					return m_reversed_bits[0] << -first;
+				}
+				const auto word = static_cast<std::size_t>(first / 64);
+				const auto offset = static_cast<unsigned>(first % 64);
+				const uint64_t low = m_reversed_bits[word] >> offset;
+				const uint64_t high = (offset != 0 && word + 1 < m_reversed_bits.size()) ? (m_reversed_bits[word + 1] << (64 - offset)) : 0;
+				return low | high;
+			}
+
+			// Bit i of word w in the AND is set if both b = 64w + i and target - b are available.
+			bool find_two_bitmap(std::size_t first, T target)
+			{
+				if (target < 0 || static_cast<uint64_t>(target) > 2 * static_cast<uint64_t>(m_max_value))
+				{
+					return false;
+				}
+				const auto sum = static_cast<std::size_t>(target);
+				// Only look at b <= target - b.
+				const std::size_t last_b = std::min(sum / 2, m_max_value);
+				const auto shift = static_cast<std::ptrdiff_t>(m_max_value) - static_cast<std::ptrdiff_t>(sum);
+				for (std::size_t word = 0; word <= last_b / 64; ++word)
+				{
+					uint64_t candidates = m_bits[word] & reversed_word_at(shift + static_cast<std::ptrdiff_t>(word * 64));
+					if (word == last_b / 64 && last_b % 64 != 63)
+					{
+						candidates &= (uint64_t{ 1 } << (last_b % 64 + 1)) - 1;
+					}
+					for (; candidates != 0; candidates &= candidates - 1)
+					{
+						const std::size_t b = word * 64 + std::countr_zero(candidates);
+						const std::size_t c = sum - b;
+						if (b == c && m_counts[b] < 2)
+						{
+							continue;
+						}
+						const auto b_pos = std::lower_bound(begin(m_sorted) + first, end(m_sorted), static_cast<T>(b)) - begin(m_sorted);
+						const auto c_pos = (b == c) ? b_pos + 1 : std::lower_bound(begin(m_sorted) + first, end(m_sorted), static_cast<T>(c)) - begin(m_sorted);
+						m_chosen.push_back(static_cast<std::size_t>(b_pos));
+						m_chosen.push_back(static_cast<std::size_t>(c_pos));
+						return true;
+					}
+				}
+				return false;
+			}
+
+			void build_pair_table()
+			{
+				for (std::size_t i = 0; i < m_sorted.size(); ++i)
+				{
+					if (i == 0 || m_sorted[i] != m_sorted[i - 1])
+					{
+						m_value_starts.push_back(i);
+					}
+				}
+				m_value_starts.push_back(m_sorted.size());
+				const std::size_t num_distinct = m_value_starts.size() - 1;
+				assert(num_distinct <= UINT32_MAX);
+				m_pairs.reserve(num_distinct * (num_distinct + 1) / 2);
+				for (std::size_t low = 0; low < num_distinct; ++low)
+				{
+					const T low_value = m_sorted[m_value_starts[low]];
+					const bool repeated = m_value_starts[low + 1] - m_value_starts[low] > 1;
+					for (std::size_t high = repeated ? low : low + 1; high < num_distinct; ++high)
+					{
+						m_pairs.push_back(k_sum_pair<T>{ low_value + m_sorted[m_value_starts[high]], static_cast<uint32_t>(low), static_cast<uint32_t>(high) });
+					}
+				}
+				std::sort(begin(m_pairs), end(m_pairs), [](const k_sum_pair<T>& left, const k_sum_pair<T>& right)
+				{
+					return left.sum != right.sum ? left.sum < right.sum : left.low > right.low;
+				});
+			}
+
+			// Picks the values of both pairs from the positions from first onwards, if there are enough of them.
+			bool choose_pairs(std::size_t first, const k_sum_pair<T>& left, const k_sum_pair<T>& right)
+			{
+				std::array<uint32_t, 4> values{ left.low, left.high, right.low, right.high };
+				std::sort(begin(values), end(values));
+				for (std::size_t i = 0; i < values.size(); ++i)
+				{
+					const std::size_t start = std::max(first, m_value_starts[values[i]]);
+					const std::size_t num_before = static_cast<std::size_t>(std::count(begin(values), begin(values) + i, values[i]));
+					if (start + num_before >= m_value_starts[values[i] + 1])
+					{
+						m_chosen.resize(m_chosen.size() - i);
+						return false;
+					}
+					m_chosen.push_back(start + num_before);
+				}
+				return true;
+			}
+
+			// first_value is the distinct value at first, which may have some of its positions before first.
+			// Each value has only one partner making a given sum, so pairs in the same group never share
+			// a value, and only a few right pairs can clash with any left pair.
+			bool find_in_groups(std::size_t first, std::size_t first_value, std::size_t left_begin, std::size_t left_end, std::size_t right_begin, std::size_t right_end)
+			{
+				for (std::size_t left = left_begin; left < left_end && m_pairs[left].low >= first_value; ++left)
+				{
+					for (std::size_t right = right_begin; right < right_end && m_pairs[right].low >= first_value; ++right)
+					{
+						if (choose_pairs(first, m_pairs[left], m_pairs[right]))
+						{
+							return true;
+						}
+					}
+				}
+				return false;
+			}
+
+			// Walks groups of pairs with the same sum in from both ends of the table, as two_pointer does
+			// with single values. Pairs made from values before first are skipped when the groups are searched.
+			bool find_four(std::size_t first, T target)
+			{
+				const auto first_value = static_cast<std::size_t>(std::upper_bound(begin(m_value_starts), end(m_value_starts), first) - begin(m_value_starts) - 1);
+				const auto group_end = [this](std::size_t begin_pos)
+				{
+					std::size_t result = begin_pos + 1;
+					while (result < m_pairs.size() && m_pairs[result].sum == m_pairs[begin_pos].sum) ++result;
+					return result;
+				};
+				const auto group_begin = [this](std::size_t end_pos)
+				{
+					std::size_t result = end_pos - 1;
+					while (result > 0 && m_pairs[result - 1].sum == m_pairs[end_pos - 1].sum) --result;
+					return result;
+				};
+				if (m_pairs.empty())
+				{
+					return false;
+				}
+				std::size_t left_begin = 0;
+				std::size_t left_end = group_end(0);
+				std::size_t right_end = m_pairs.size();
+				std::size_t right_begin = group_begin(right_end);
+				while (left_begin < right_end)
+				{
+					const T sum = m_pairs[left_begin].sum + m_pairs[right_begin].sum;
+					if (sum == target && find_in_groups(first, first_value, left_begin, left_end, right_begin, right_end))
+					{
+						return true;
+					}
+					if (sum <= target)
+					{
+						left_begin = left_end;
+						if (left_begin < right_end)
+						{
+							left_end = group_end(left_begin);
+						}
+					}
+					if (sum >= target)
+					{
+						right_end = right_begin;
+						if (right_end > left_begin)
+						{
+							right_begin = group_begin(right_end);
+						}
+					}
+				}
+				return false;
+			}
+
+			bool solve(std::size_t first, std::size_t k, T target)
+			{
+				if (m_sorted.size() - first < k)
+				{
+					return false;
+				}
+				if (k == 1)
+				{
+					return find_one(first, target);
+				}
+				if (k == 2)
+				{
+					switch (m_strategy)
+					{
+					case k_sum_strategy::hash_set:
+						return find_two_hashed(first, target);
+					case k_sum_strategy::bitmap:
+						return find_two_bitmap(first, target);
+					default:
+						return find_two_pointer(first, target);
+					}
+				}
+				if (k == 4 && m_strategy == k_sum_strategy::meet_in_the_middle)
+				{
+					return find_four(first, target);
+				}
+				const T largest_rest = largest_sum(k - 1);
+				bool found = false;
+				std::size_t taken_until = first;
+				for (std::size_t i = first; i + k <= m_sorted.size(); ++i)
+				{
+					take_out(i);
+					taken_until = i + 1;
+					// If this value didn't work, an equal one later on can't either.
+					if (i > first && m_sorted[i] == m_sorted[i - 1])
+					{
+						continue;
+					}
+					const T rest = target - m_sorted[i];
+					if (smallest_sum(i + 1, k - 1) > rest)
+					{
+						break;
+					}
+					if (largest_rest < rest)
+					{
+						continue;
+					}
+					m_chosen.push_back(i);
+					if (solve(i + 1, k - 1, rest))
+					{
+						found = true;
+						break;
+					}
+					m_chosen.pop_back();
+				}
+				for (std::size_t i = first; i < taken_until; ++i)
+				{
+					put_back(i);
+				}
+				return found;
+			}
+
+		public:
+			k_sum_solver(const std::vector<T>& values, k_sum_strategy strategy)
+				: m_strategy{ strategy }
+			{
+				m_original.resize(values.size());
+				std::iota(begin(m_original), end(m_original), std::size_t{ 0 });
+				std::sort(begin(m_original), end(m_original), [&values](std::size_t left, std::size_t right)
+				{
+					return values[left] < values[right];
+				});
+				m_sorted.reserve(values.size());
+				std::transform(begin(m_original), end(m_original), std::back_inserter(m_sorted), [&values](std::size_t idx)
+				{
+					return values[idx];
+				});
+				if (m_strategy == k_sum_strategy::hash_set)
+				{
+					m_last_position.reserve(m_sorted.size());
+					for (std::size_t i = 0; i < m_sorted.size(); ++i)
+					{
+						m_last_position[m_sorted[i]] = i;
+					}
+				}
+				if (m_strategy == k_sum_strategy::bitmap)
+				{
+					assert(m_sorted.empty() || m_sorted.front() >= 0);
+					m_max_value = m_sorted.empty() ? 0 : static_cast<std::size_t>(m_sorted.back());
+					m_counts.assign(m_max_value + 1, 0);
+					m_bits.assign(m_max_value / 64 + 1, 0);
+					m_reversed_bits.assign(m_max_value / 64 + 1, 0);
+					for (std::size_t i = 0; i < m_sorted.size(); ++i)
+					{
+						put_back(i);
+					}
+				}
+			}
+
+			std::optional<std::vector<std::size_t>> find(std::size_t k, T target)
+			{
+				m_chosen.clear();
+				if (m_strategy == k_sum_strategy::meet_in_the_middle && k >= 4 && m_value_starts.empty())
+				{
+					build_pair_table();
+				}
+				if (!solve(0, k, target))
+				{
+					return std::nullopt;
+				}
+				std::vector<std::size_t> result;
+				result.reserve(k);
+				std::transform(begin(m_chosen), end(m_chosen), std::back_inserter(result), [this](std::size_t pos)
+				{
+					return m_original[pos];
+				});
+				std::sort(begin(result), end(result));
+				return result;
+			}
+		};
+	}
+
+	// Values are in [min_value, max_value].
+	template <std::integral T>
+	k_sum_strategy choose_k_sum_strategy(std::size_t num_values, std::size_t k, T min_value, T max_value,
+		uint64_t max_bitmap_value = DEFAULT_K_SUM_MAX_BITMAP_VALUE, uint64_t memory_budget = DEFAULT_K_SUM_MEMORY_BUDGET) noexcept
+	{
+		const bool small_domain = min_value >= 0 && static_cast<uint64_t>(max_value) <= max_bitmap_value;
+		const bool pair_table_fits = internals::k_sum_pair_table_bytes<T>(num_values) <= memory_budget;
+		if (small_domain && (k <= 3 || !pair_table_fits))
+		{
+			return k_sum_strategy::bitmap;
+		}
+		if (k <= 2)
+		{
+			return k_sum_strategy::hash_set;
+		}
+		if (k >= 4 && pair_table_fits)
+		{
+			return k_sum_strategy::meet_in_the_middle;
+		}
+		return k_sum_strategy::two_pointer;
+	}
+
+	// Returns the indices of k values adding up to target, in increasing order, or nullopt if there aren't any.
+	// bitmap can only be used when no value is negative.
+	template <std::integral T>
+	std::optional<std::vector<std::size_t>> find_k_sum(const std::vector<T>& values, std::size_t k, T target,
+		k_sum_strategy strategy = k_sum_strategy::automatic, uint64_t max_bitmap_value = DEFAULT_K_SUM_MAX_BITMAP_VALUE,
+		uint64_t memory_budget = DEFAULT_K_SUM_MEMORY_BUDGET)
+	{
+		assert(k > 0);
+		if (strategy == k_sum_strategy::automatic)
+		{
+			const auto [min_it, max_it] = std::minmax_element(begin(values), end(values));
+			strategy = values.empty() ? k_sum_strategy::two_pointer : choose_k_sum_strategy(values.size(), k, *min_it, *max_it, max_bitmap_value, memory_budget);
+		}
+		return internals::k_sum_solver<T>{ values, strategy }.find(k, target);
+	}
+
+	// Returns the product of k values adding up to target, or nullopt if there aren't any.
+	template <std::integral T>
+	std::optional<T> k_sum_product(const std::vector<T>& values, std::size_t k, T target,
+		k_sum_strategy strategy = k_sum_strategy::automatic, uint64_t max_bitmap_value = DEFAULT_K_SUM_MAX_BITMAP_VALUE,
+		uint64_t memory_budget = DEFAULT_K_SUM_MEMORY_BUDGET)
+	{
+		const auto indices = find_k_sum(values, k, target, strategy, max_bitmap_value, memory_budget);
+		if (!indices.has_value())
+		{
+			return std::nullopt;
+		}
+		T result{ 1 };
+		for (std::size_t idx : *indices)
+		{
+			result *= values[idx];
+		}
+		return result;
+	}
+}
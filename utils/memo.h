@@ -0,0 +1,287 @@
+#pragma once
+
+// Caches for the results of expensive (usually recursive) functions.
+// memo is a flat open-addressing table. A key can only be stored within a few slots of where
+// it hashes to, so lookups stay short. Give it a max_size to bound its memory: once it is that big,
+// adding a key throws out the least recently used entry near where the new one goes.
+// Without a max_size it grows instead, and never forgets anything.
+// If growing doesn't make room, too many keys share a hash. A bounded memo then throws out an entry
+// early, and an unbounded one doubles how far it probes, so a poor Hash makes it slower without running out of memory.
+//
+// concurrent_memo splits the keys between several memos, each with its own lock, so that
+// threads working on different keys rarely wait for each other.
+//
+// Like flat_hash_map, keys and values must be default constructible.
+
+#include "hash_combine.h"
+
+#include <vector>
+#include <array>
+#include <bit>
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <functional>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace utils
+{
+	template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class memo
+	{
+		static constexpr std::size_t DEFAULT_PROBE_LIMIT = 8;
+		static constexpr std::size_t MIN_CAPACITY = 16;
+
+		std::vector<Key> m_keys;
+		std::vector<Value> m_values;
+		// When each slot was last used. 0 marks an empty slot.
+		std::vector<uint64_t> m_last_used;
+		uint64_t m_clock = 0;
+		std::size_t m_size = 0;
+		std::size_t m_mask = 0;
+		std::size_t m_max_size = 0;
+		// Only ever goes up, and only in an unbounded memo.
+		std::size_t m_probe_limit = DEFAULT_PROBE_LIMIT;
+		Hash m_hash;
+		KeyEqual m_equal;
+
+		// std::hash of an integer is often the integer itself, so mix it before masking.
+		std::size_t home_slot(const Key& key) const
+		{
+			return static_cast<std::size_t>(hash_mix(m_hash(key))) & m_mask;
+		}
+
+		std::optional<std::size_t> find_slot(const Key& key) const
+		{
+			if (m_size == 0)
+			{
+				return std::nullopt;
+			}
+			const std::size_t home = home_slot(key);
+			const std::size_t probe_limit = std::min(m_probe_limit, m_keys.size());
+			for (std::size_t i = 0; i < probe_limit; ++i)
+			{
+				const std::size_t idx = (home + i) & m_mask;
+				// Nothing is ever removed from the middle of a run, so an empty slot ends the search.
+				if (m_last_used[idx] == 0)
+				{
+					return std::nullopt;
+				}
+				if (m_equal(m_keys[idx], key))
+				{
+					return idx;
+				}
+			}
+			return std::nullopt;
+		}
+
+		bool can_grow() const noexcept
+		{
+			return m_max_size == 0 || m_keys.size() < m_max_size;
+		}
+
+		void resize(std::size_t new_capacity)
+		{
+			std::vector<Key> old_keys = std::move(m_keys);
+			std::vector<Value> old_values = std::move(m_values);
+			std::vector<uint64_t> old_last_used = std::move(m_last_used);
+			m_keys.assign(new_capacity, Key{});
+			m_values.assign(new_capacity, Value{});
+			m_last_used.assign(new_capacity, 0);
+			m_mask = new_capacity - 1;
+			m_size = 0;
+			for (std::size_t i = 0; i < old_keys.size(); ++i)
+			{
+				if (old_last_used[i] != 0)
+				{
+					place(std::move(old_keys[i]), std::move(old_values[i]), old_last_used[i]);
+				}
+			}
+		}
+
+		// key must not be in the table already.
+		void place(Key key, Value value, uint64_t last_used)
+		{
+			bool grown_for_key = false;
+			while (true)
+			{
+				if (m_keys.empty() || (can_grow() && 2 * (m_size + 1) > m_keys.size()))
+				{
+					resize(std::max(MIN_CAPACITY, 2 * m_keys.size()));
+					continue;
+				}
+				const std::size_t home = home_slot(key);
+				const std::size_t probe_limit = std::min(m_probe_limit, m_keys.size());
+				std::size_t oldest = home;
+				for (std::size_t i = 0; i < probe_limit; ++i)
+				{
+					const std::size_t idx = (home + i) & m_mask;
+					if (m_last_used[idx] == 0)
+					{
+						m_keys[idx] = std::move(key);
+						m_values[idx] = std::move(value);
+						m_last_used[idx] = last_used;
+						++m_size;
+						return;
+					}
+					if (m_last_used[idx] < m_last_used[oldest])
+					{
+						oldest = idx;
+					}
+				}
+				// Every slot in reach is taken. Growing spreads the keys out, unless they share a hash.
+				if (can_grow() && !grown_for_key)
+				{
+					resize(2 * m_keys.size());
+					grown_for_key = true;
+					continue;
+				}
+				// The table is at most half full, so probing far enough always finds an empty slot.
+				if (m_max_size == 0)
+				{
+					m_probe_limit *= 2;
+					continue;
+				}
+				m_keys[oldest] = std::move(key);
+				m_values[oldest] = std::move(value);
+				m_last_used[oldest] = last_used;
+				return;
+			}
+		}
+
+	public:
+		using key_type = Key;
+		using mapped_type = Value;
+
+		// A max_size of 0 means no limit. Otherwise it is rounded up to a power of two.
+		explicit memo(std::size_t max_size = 0)
+			: m_max_size{ max_size == 0 ? 0 : std::bit_ceil(std::max(max_size, MIN_CAPACITY)) }
+		{
+		}
+
+		std::size_t size() const noexcept { return m_size; }
+		bool empty() const noexcept { return m_size == 0; }
+		std::size_t capacity() const noexcept { return m_keys.size(); }
+		std::size_t max_size() const noexcept { return m_max_size; }
+
+		void clear()
+		{
+			std::fill(begin(m_last_used), end(m_last_used), uint64_t{ 0 });
+			m_size = 0;
+		}
+
+		std::optional<Value> find(const Key& key)
+		{
+			if (const auto idx = find_slot(key))
+			{
+				m_last_used[*idx] = ++m_clock;
+				return m_values[*idx];
+			}
+			return std::nullopt;
+		}
+
+		bool contains(const Key& key) const
+		{
+			return find_slot(key).has_value();
+		}
+
+		void insert(const Key& key, Value value)
+		{
+			if (const auto idx = find_slot(key))
+			{
+				m_values[*idx] = std::move(value);
+				m_last_used[*idx] = ++m_clock;
+				return;
+			}
+			place(key, std::move(value), ++m_clock);
+		}
+
+		// Returns the cached value for key, or calls compute() and caches that.
+		// compute may use this memo itself, as no slot is held onto while it runs.
+		template <typename Func>
+		Value get_or_compute(const Key& key, Func&& compute)
+		{
+			if (auto cached = find(key))
+			{
+				return std::move(*cached);
+			}
+			Value result = compute();
+			insert(key, result);
+			return result;
+		}
+	};
+
+	template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class concurrent_memo
+	{
+		static constexpr std::size_t NUM_SHARDS = 16;
+
+		struct Shard
+		{
+			std::mutex mutex;
+			memo<Key, Value, Hash, KeyEqual> table;
+		};
+
+		std::array<Shard, NUM_SHARDS> m_shards;
+		Hash m_hash;
+
+		// The memos use the low bits of the mixed hash, so pick the shard with the high ones.
+		Shard& shard_for(const Key& key)
+		{
+			const uint64_t mixed = hash_mix(m_hash(key));
+			return m_shards[static_cast<std::size_t>(mixed >> 60) % NUM_SHARDS];
+		}
+
+	public:
+		// max_size is shared out between the shards. 0 means no limit.
+		explicit concurrent_memo(std::size_t max_size = 0)
+		{
+			for (Shard& shard : m_shards)
+			{
+				shard.table = memo<Key, Value, Hash, KeyEqual>{ (max_size + NUM_SHARDS - 1) / NUM_SHARDS };
+			}
+		}
+
+		std::size_t size()
+		{
+			std::size_t result = 0;
+			for (Shard& shard : m_shards)
+			{
+				std::lock_guard lock{ shard.mutex };
+				result += shard.table.size();
+			}
+			return result;
+		}
+
+		std::optional<Value> find(const Key& key)
+		{
+			Shard& shard = shard_for(key);
+			std::lock_guard lock{ shard.mutex };
+			return shard.table.find(key);
+		}
+
+		void insert(const Key& key, Value value)
+		{
+			Shard& shard = shard_for(key);
+			std::lock_guard lock{ shard.mutex };
+			shard.table.insert(key, std::move(value));
+		}
+
+		// The lock isn't held while compute() runs, so it can recurse into the memo. Two threads
+		// asking for the same missing key at once may both compute it, and the later result is kept.
+		template <typename Func>
+		Value get_or_compute(const Key& key, Func&& compute)
+		{
+			if (auto cached = find(key))
+			{
+				return std::move(*cached);
+			}
+			Value result = compute();
+			insert(key, result);
+			return result;
+		}
+	};
+}
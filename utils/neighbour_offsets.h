@@ -0,0 +1,106 @@
+#pragma once
+
+// Compile-time tables of the 3^DIM-1 neighbour offsets around a cell in DIM dimensions.
+// Loops over these are fixed-length, so the compiler can unroll them.
+
+#include <array>
+#include <cstddef>
+
+namespace utils
+{
+	template <std::size_t DIM>
+	constexpr std::size_t num_neighbours() noexcept
+	{
+		std::size_t result = 1;
+		for (std::size_t i = 0; i < DIM; ++i)
+		{
+			result *= 3;
+		}
+		return result - 1;
+	}
+
+	// Offsets in order of counting up in base 3 with digits -1, 0, +1, with dimension 0 as the lowest digit.
+	// The all-zero offset is skipped.
+	template <std::size_t DIM, typename T = int>
+	constexpr std::array<std::array<T, DIM>, num_neighbours<DIM>()> make_neighbour_offsets() noexcept
+	{
+		std::array<std::array<T, DIM>, num_neighbours<DIM>()> result{};
+		std::array<T, DIM> offset{};
+		for (auto& o : offset)
+		{
+			o = -1;
+		}
+
+		// With digits -1, 0, +1 the all-zero offset is the one halfway through the count.
+		constexpr std::size_t centre = num_neighbours<DIM>() / 2;
+		std::size_t out_idx = 0;
+		for (std::size_t n = 0; n <= num_neighbours<DIM>(); ++n)
+		{
+			if (n != centre)
+			{
+				result[out_idx++] = offset;
+			}
+
+			for (std::size_t digit = 0; digit < DIM; ++digit)
+			{
+				if (offset[digit] != 1)
+				{
+					++offset[digit];
+					break;
+				}
+				offset[digit] = -1;
+			}
+		}
+		return result;
+	}
+
+	template <std::size_t DIM, typename T = int>
+	inline constexpr auto neighbour_offsets = make_neighbour_offsets<DIM, T>();
+
+	// For a dense grid where index = sum(coord[i] * strides[i]), gives the index delta for each neighbour,
+	// in the same order as make_neighbour_offsets.
+	template <std::size_t DIM>
+	constexpr std::array<std::ptrdiff_t, num_neighbours<DIM>()> make_linear_neighbour_deltas(const std::array<std::ptrdiff_t, DIM>& strides) noexcept
+	{
+		std::array<std::ptrdiff_t, num_neighbours<DIM>()> result{};
+		const auto& offsets = neighbour_offsets<DIM, std::ptrdiff_t>;
+		for (std::size_t n = 0; n < offsets.size(); ++n)
+		{
+			std::ptrdiff_t delta = 0;
+			for (std::size_t i = 0; i < DIM; ++i)
+			{
+				delta += offsets[n][i] * strides[i];
+			}
+			result[n] = delta;
+		}
+		return result;
+	}
+
+	// Strides for a row-major grid, where dimension 0 varies fastest.
+	template <std::size_t DIM>
+	constexpr std::array<std::ptrdiff_t, DIM> make_dense_strides(const std::array<std::ptrdiff_t, DIM>& extents) noexcept
+	{
+		std::array<std::ptrdiff_t, DIM> result{};
+		std::ptrdiff_t stride = 1;
+		for (std::size_t i = 0; i < DIM; ++i)
+		{
+			result[i] = stride;
+			stride *= extents[i];
+		}
+		return result;
+	}
+
+	namespace internals
+	{
+		static_assert(neighbour_offsets<2>.size() == 8);
+		static_assert(neighbour_offsets<3>.size() == 26);
+		static_assert(num_neighbours<8>() == 6560);
+		static_assert(neighbour_offsets<2>[0][0] == -1 && neighbour_offsets<2>[0][1] == -1);
+		static_assert(neighbour_offsets<2>[3][0] == -1 && neighbour_offsets<2>[3][1] == 0);
+		static_assert(neighbour_offsets<2>[4][0] == 1 && neighbour_offsets<2>[4][1] == 0);
+		static_assert(neighbour_offsets<2>[5][0] == -1 && neighbour_offsets<2>[5][1] == 1);
+		static_assert(make_linear_neighbour_deltas<2>(make_dense_strides<2>({ 10,10 }))[0] == -11);
+		static_assert(make_linear_neighbour_deltas<2>(make_dense_strides<2>({ 10,10 }))[4] == 1);
+		static_assert(make_linear_neighbour_deltas<2>(make_dense_strides<2>({ 10,10 }))[7] == 11);
+	}
+}
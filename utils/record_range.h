@@ -0,0 +1,172 @@
+#pragma once
+
+// Ranges over text that's already in memory, without copying it.
+// record_range gives each block of lines between blank lines, and line_range gives each line.
+// A line with nothing but whitespace on it counts as blank, and "\r\n" line endings are fine:
+// the '\r' is left off the end of each line and record.
+//
+// split_records_into_chunks cuts the text up for handing to several threads. Each chunk ends where
+// a blank line starts, so every record is wholly in one chunk, and each chunk can have its own record_range.
+
+#include "char_class.h"
+
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <iterator>
+#include <algorithm>
+#include <cstddef>
+
+namespace utils
+{
+	namespace internals
+	{
+		inline std::size_t line_end(std::string_view text, std::size_t line_start) noexcept
+		{
+			return std::min(text.find('\n', line_start), text.size());
+		}
+
+		inline bool is_blank(std::string_view line) noexcept
+		{
+			return all_in(line, space_chars);
+		}
+
+		inline std::string_view without_cr(std::string_view line) noexcept
+		{
+			if (!line.empty() && line.back() == '\r')
+			{
+				line.remove_suffix(1);
+			}
+			return line;
+		}
+
+		struct take_line
+		{
+			std::optional<std::string_view> operator()(std::string_view& rest) const noexcept
+			{
+				if (rest.empty())
+				{
+					return std::nullopt;
+				}
+				const std::size_t end = line_end(rest, 0);
+				const std::string_view result = rest.substr(0, end);
+				rest.remove_prefix(std::min(end + 1, rest.size()));
+				return without_cr(result);
+			}
+		};
+
+		struct take_record
+		{
+			std::optional<std::string_view> operator()(std::string_view& rest) const noexcept
+			{
+				std::size_t pos = 0;
+				while (pos < rest.size() && is_blank(rest.substr(pos, line_end(rest, pos) - pos)))
+				{
+					pos = line_end(rest, pos) + 1;
+				}
+				if (pos >= rest.size())
+				{
+					rest.remove_prefix(rest.size());
+					return std::nullopt;
+				}
+				const std::size_t record_start = pos;
+				std::size_t record_end = pos;
+				while (pos < rest.size())
+				{
+					const std::size_t end = line_end(rest, pos);
+					if (is_blank(rest.substr(pos, end - pos)))
+					{
+						break;
+					}
+					record_end = end;
+					pos = end + 1;
+				}
+				const std::string_view result = rest.substr(record_start, record_end - record_start);
+				rest.remove_prefix(std::min(pos, rest.size()));
+				return without_cr(result);
+			}
+		};
+
+		template <typename Take>
+		class text_range
+		{
+			std::string_view m_text;
+		public:
+			class iterator
+			{
+				std::string_view m_rest;
+				std::optional<std::string_view> m_current;
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = std::string_view;
+				using difference_type = std::ptrdiff_t;
+				using pointer = const std::string_view*;
+				using reference = const std::string_view&;
+
+				iterator() noexcept = default;
+				explicit iterator(std::string_view text) noexcept : m_rest{ text }, m_current{ Take{}(m_rest) } {}
+
+				bool operator==(const iterator& other) const noexcept
+				{
+					if (!m_current.has_value() || !other.m_current.has_value())
+					{
+						return m_current.has_value() == other.m_current.has_value();
+					}
+					return m_current->data() == other.m_current->data();
+				}
+
+				reference operator*() const noexcept { return *m_current; }
+				pointer operator->() const noexcept { return &*m_current; }
+				iterator& operator++() noexcept
+				{
+					m_current = Take{}(m_rest);
+					return *this;
+				}
+				iterator operator++(int) noexcept
+				{
+					const iterator result = *this;
+					++(*this);
+					return result;
+				}
+			};
+
+			explicit text_range(std::string_view text) noexcept : m_text{ text } {}
+			iterator begin() const noexcept { return iterator{ m_text }; }
+			iterator end() const noexcept { return iterator{}; }
+		};
+	}
+
+	using record_range = internals::text_range<internals::take_record>;
+	using line_range = internals::text_range<internals::take_line>;
+
+	// Splits text into at most num_chunks pieces of about the same size, made of whole records.
+	inline std::vector<std::string_view> split_records_into_chunks(std::string_view text, std::size_t num_chunks)
+	{
+		std::vector<std::string_view> result;
+		std::size_t chunk_start = 0;
+		for (std::size_t i = 1; i < num_chunks && chunk_start < text.size(); ++i)
+		{
+			// Go to the start of the next line, then on to the next blank line.
+			std::size_t boundary = std::max(chunk_start, text.size() * i / num_chunks);
+			if (boundary > 0 && text[boundary - 1] != '\n')
+			{
+				boundary = internals::line_end(text, boundary) + 1;
+			}
+			while (boundary < text.size() && !internals::is_blank(text.substr(boundary, internals::line_end(text, boundary) - boundary)))
+			{
+				boundary = internals::line_end(text, boundary) + 1;
+			}
+			boundary = std::min(boundary, text.size());
+			if (boundary > chunk_start)
+			{
+				result.push_back(text.substr(chunk_start, boundary - chunk_start));
+				chunk_start = boundary;
+			}
+		}
+		if (chunk_start < text.size())
+		{
+			result.push_back(text.substr(chunk_start));
+		}
+		return result;
+	}
+}
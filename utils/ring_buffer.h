@@ -2,23 +2,55 @@
 
 #include <vector>
 #include <algorithm>
+#include <bit>
+#include <utility>
+#include <cassert>
 
 #include "index_iterator2.h"
 
 namespace utils
 {
-	template <typename  T, std::size_t SIZE>
+	// A double-ended queue in one contiguous block. Capacity is always a power of two,
+	// so indexing is a mask rather than a division. Elements in unused slots are
+	// default constructed, so T must be default constructible.
+	// SIZE is the number of default constructed elements it starts with.
+	template <typename  T, std::size_t SIZE = 0>
 	class ring_buffer
 	{
+		static constexpr std::size_t MIN_CAPACITY = 8;
 		std::vector<T> m_data;
-		std::size_t m_front_idx;
+		std::size_t m_front_idx = 0;
+		std::size_t m_size = 0;
+		std::size_t m_mask = 0;
 		constexpr std::size_t get_idx(std::size_t i) const noexcept
 		{
-			return (i + m_front_idx) % SIZE;
+			return (i + m_front_idx) & m_mask;
+		}
+
+		void set_capacity(std::size_t new_capacity)
+		{
+			assert(std::has_single_bit(new_capacity));
+			assert(new_capacity >= m_size);
+			std::vector<T> new_data(new_capacity);
+			for (std::size_t i = 0; i < m_size; ++i)
+			{
+				new_data[i] = std::move((*this)[i]);
+			}
+			m_data.swap(new_data);
+			m_front_idx = 0;
+			m_mask = new_capacity - 1;
+		}
+
+		void grow_if_full()
+		{
+			if (m_size == m_data.size())
+			{
+				set_capacity(std::max(MIN_CAPACITY, 2 * m_data.size()));
+			}
 		}
 	public:
 		using value_type = T;
-		using side_type = std::size_t;
+		using size_type = std::size_t;
 		using difference_type = std::ptrdiff_t;
 		using reference_type = T&;
 		using const_reference_type = const T&;
@@ -27,26 +59,135 @@ namespace utils
 		using iterator = index_iterator2<ring_buffer<T, SIZE>>;
 		using const_iterator = const_index_iterator2<ring_buffer<T, SIZE>>;
 
-		explicit ring_buffer() { m_data.resize(SIZE); }
+		explicit ring_buffer() { resize(SIZE); }
 
 		ring_buffer(const ring_buffer&) = default;
 		ring_buffer(ring_buffer&&) = default;
 		ring_buffer& operator=(const ring_buffer&) = default;
 		ring_buffer& operator=(ring_buffer&&) = default;
-		T& operator[](std::size_t i) noexcept { return m_data[get_idx(i)]; }
-		const T& operator[](std::size_t i) const noexcept { return m_data[get_idx(i)]; }
+		T& operator[](std::size_t i) noexcept { assert(i < m_size); return m_data[get_idx(i)]; }
+		const T& operator[](std::size_t i) const noexcept { assert(i < m_size); return m_data[get_idx(i)]; }
 		T& front() { return (*this)[0]; }
 		const T& front() const { return (*this)[0]; }
-		T& back() { return (*this)[SIZE - 1]; }
-		const T& back() const { return (*this)[SIZE - 1]; }
+		T& back() { return (*this)[m_size - 1]; }
+		const T& back() const { return (*this)[m_size - 1]; }
 
-		bool empty() const { return m_data.empty(); }
-		std::size_t size() const { return m_data.size(); }
+		bool empty() const { return m_size == 0; }
+		std::size_t size() const { return m_size; }
+		std::size_t capacity() const { return m_data.size(); }
 		std::size_t max_size() const { return m_data.max_size(); }
 
-		void fill(const T& value) { m_data.fill(value); }
-		void swap(ring_buffer& other) { m_data.swap(other.m_data); std::swap(m_front_idx, other.m_front_idx); }
-		void rotate(std::size_t new_front) { m_front_idx = get_idx(new_front); }
+		void reserve(std::size_t new_capacity)
+		{
+			if (new_capacity > m_data.size())
+			{
+				set_capacity(std::bit_ceil(std::max(MIN_CAPACITY, new_capacity)));
+			}
+		}
+
+		// New elements are default constructed at the back.
+		void resize(std::size_t new_size)
+		{
+			reserve(new_size);
+			while (m_size > new_size)
+			{
+				pop_back();
+			}
+			m_size = new_size;
+		}
+
+		void clear()
+		{
+			resize(0);
+			m_front_idx = 0;
+		}
+
+		template <typename... Args>
+		T& emplace_back(Args&&... args)
+		{
+			grow_if_full();
+			T& result = m_data[get_idx(m_size)];
+			result = T(std::forward<Args>(args)...);
+			++m_size;
+			return result;
+		}
+
+		template <typename... Args>
+		T& emplace_front(Args&&... args)
+		{
+			grow_if_full();
+			m_front_idx = (m_front_idx + m_mask) & m_mask;
+			T& result = m_data[m_front_idx];
+			result = T(std::forward<Args>(args)...);
+			++m_size;
+			return result;
+		}
+
+		void push_back(const T& value) { emplace_back(value); }
+		void push_back(T&& value) { emplace_back(std::move(value)); }
+		void push_front(const T& value) { emplace_front(value); }
+		void push_front(T&& value) { emplace_front(std::move(value)); }
+
+		// Popped slots are reset, so any resources held by the element are released straight away.
+		void pop_front()
+		{
+			assert(!empty());
+			m_data[m_front_idx] = T{};
+			m_front_idx = (m_front_idx + 1) & m_mask;
+			--m_size;
+		}
+
+		void pop_back()
+		{
+			assert(!empty());
+			back() = T{};
+			--m_size;
+		}
+
+		void fill(const T& value)
+		{
+			for (std::size_t i = 0; i < m_size; ++i)
+			{
+				(*this)[i] = value;
+			}
+		}
+
+		void swap(ring_buffer& other)
+		{
+			m_data.swap(other.m_data);
+			std::swap(m_front_idx, other.m_front_idx);
+			std::swap(m_size, other.m_size);
+			std::swap(m_mask, other.m_mask);
+		}
+
+		// Makes element new_front the first one. This is free when the buffer is full. Otherwise
+		// the elements on the shorter side are moved one at a time across the unused slots,
+		// from the front to the back or the other way round, so nothing is reallocated.
+		void rotate(std::size_t new_front)
+		{
+			assert(new_front <= m_size);
+			if (m_size == m_data.size())
+			{
+				m_front_idx = get_idx(new_front);
+				return;
+			}
+			if (new_front <= m_size - new_front)
+			{
+				for (std::size_t i = 0; i < new_front; ++i)
+				{
+					m_data[get_idx(m_size)] = std::move(m_data[m_front_idx]);
+					m_front_idx = (m_front_idx + 1) & m_mask;
+				}
+			}
+			else
+			{
+				for (std::size_t i = new_front; i < m_size; ++i)
+				{
+					m_front_idx = (m_front_idx + m_mask) & m_mask;
+					m_data[m_front_idx] = std::move(m_data[get_idx(m_size)]);
+				}
+			}
+		}
 		void rotate(const_iterator new_front) { rotate(new_front - begin()); }
 
 		const_iterator cbegin() const
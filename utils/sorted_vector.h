@@ -1,33 +1,46 @@
+#pragma once
+
 #include <vector>
 #include <algorithm>
 #include <functional>
+#include <iterator>
+#include <utility>
+#include <type_traits>
 #include <cassert>
 
 namespace utils
 {
 
-	template <typename T>
+	// A vector which sorts itself lazily, the first time it's read after being modified.
+	// Duplicates are allowed, as with std::multiset. Call make_unique() to get std::set behaviour.
+	// If Compare has an is_transparent member, lookups can use any type Compare accepts.
+	template <typename T, typename Compare = std::less<T>>
 	class sorted_vector
 	{
 	public:
 		using iterator = typename std::vector<T>::iterator;
 		using const_iterator = typename std::vector<T>::const_iterator;
-		using Pred_t = std::function<bool(const T&, const T&)>;
+		using Pred_t = Compare;
+		using key_compare = Compare;
 		using value_type = T;
+		using size_type = std::size_t;
 	private:
 		mutable std::vector<T> m_data;
-		Pred_t m_compare;
+		Compare m_compare;
 		mutable bool m_sorted;
+
+		template <typename C, typename K>
+		using enable_if_transparent_t = std::enable_if_t<!std::is_convertible_v<const K&, const T&>, typename C::is_transparent>;
 	public:
-		sorted_vector(Pred_t compare = std::less<T>())
+		sorted_vector(Compare compare = Compare{})
 			: m_data()
-			, m_compare(compare)
+			, m_compare(std::move(compare))
 			, m_sorted(true)
 		{}
 		template <typename InputIt>
-		sorted_vector(InputIt start, InputIt finish, Pred_t compare = std::less<T>())
+		sorted_vector(InputIt start, InputIt finish, Compare compare = Compare{})
 			: m_data(start, finish)
-			, m_compare(compare)
+			, m_compare(std::move(compare))
 			, m_sorted(false)
 		{}
 
@@ -63,6 +76,24 @@ namespace utils
 			return m_data.size();
 		}
 
+		void reserve(std::size_t new_capacity)
+		{
+			m_data.reserve(new_capacity);
+		}
+
+		const Compare& key_comp() const noexcept
+		{
+			return m_compare;
+		}
+
+		// Removes duplicates, where two values are duplicates if neither compares less than the other.
+		void make_unique()
+		{
+			sort();
+			auto is_equivalent = [this](const T& a, const T& b) {return !m_compare(a, b); };
+			m_data.erase(std::unique(m_data.begin(), m_data.end(), is_equivalent), m_data.end());
+		}
+
 		auto lower_bound(const T& value)
 		{
 			sort();
@@ -87,16 +118,84 @@ namespace utils
 			return std::upper_bound(m_data.begin(), m_data.end(), value, m_compare);
 		}
 
+		auto equal_range(const T& value)
+		{
+			sort();
+			return std::equal_range(m_data.begin(), m_data.end(), value, m_compare);
+		}
+
+		auto equal_range(const T& value) const
+		{
+			sort();
+			return std::equal_range(m_data.begin(), m_data.end(), value, m_compare);
+		}
+
 		auto find(const T& value)
 		{
 			const auto result = lower_bound(value);
-			return (result != end() && *result == value) ? result : end();
+			return (result != end() && !m_compare(value, *result)) ? result : end();
 		}
 
 		auto find(const T& value) const
 		{
 			const auto result = lower_bound(value);
-			return (result != end() && *result == value) ? result : end();
+			return (result != end() && !m_compare(value, *result)) ? result : end();
+		}
+
+		std::size_t count(const T& value) const
+		{
+			const auto [first, last] = equal_range(value);
+			return static_cast<std::size_t>(std::distance(first, last));
+		}
+
+		// Heterogeneous lookup. Only available if Compare::is_transparent exists.
+		template <typename K, typename C = Compare, typename = enable_if_transparent_t<C, K>>
+		auto lower_bound(const K& key) const
+		{
+			sort();
+			return std::lower_bound(m_data.cbegin(), m_data.cend(), key, m_compare);
+		}
+
+		template <typename K, typename C = Compare, typename = enable_if_transparent_t<C, K>>
+		auto upper_bound(const K& key) const
+		{
+			sort();
+			return std::upper_bound(m_data.cbegin(), m_data.cend(), key, m_compare);
+		}
+
+		template <typename K, typename C = Compare, typename = enable_if_transparent_t<C, K>>
+		auto equal_range(const K& key) const
+		{
+			sort();
+			return std::equal_range(m_data.cbegin(), m_data.cend(), key, m_compare);
+		}
+
+		template <typename K, typename C = Compare, typename = enable_if_transparent_t<C, K>>
+		auto find(const K& key)
+		{
+			sort();
+			const auto result = std::lower_bound(m_data.begin(), m_data.end(), key, m_compare);
+			return (result != m_data.end() && !m_compare(key, *result)) ? result : m_data.end();
+		}
+
+		template <typename K, typename C = Compare, typename = enable_if_transparent_t<C, K>>
+		auto find(const K& key) const
+		{
+			const auto result = lower_bound(key);
+			return (result != m_data.cend() && !m_compare(key, *result)) ? result : m_data.cend();
+		}
+
+		template <typename K, typename C = Compare, typename = enable_if_transparent_t<C, K>>
+		bool contains(const K& key) const
+		{
+			return find(key) != m_data.cend();
+		}
+
+		template <typename K, typename C = Compare, typename = enable_if_transparent_t<C, K>>
+		std::size_t count(const K& key) const
+		{
+			const auto [first, last] = equal_range(key);
+			return static_cast<std::size_t>(std::distance(first, last));
 		}
 
 		const T& front() const
@@ -123,7 +222,7 @@ namespace utils
 			return m_data.back();
 		}
 
-		bool contains(const T& value)
+		bool contains(const T& value) const
 		{
 			return find(value) != end();
 		}
@@ -169,12 +268,52 @@ namespace utils
 			}
 		}
 
+		// Sorts the new values on their own and merges them in once, rather than
+		// inserting one at a time.
 		template <typename InputIterator>
 		void insert(InputIterator first, InputIterator last)
 		{
-			m_data.insert(end(m_data), first, last);
-			m_sorted = false;
-			break;
+			const auto old_size = static_cast<std::ptrdiff_t>(m_data.size());
+			m_data.insert(m_data.end(), first, last);
+			if (!m_sorted)
+			{
+				return;
+			}
+			const auto middle = m_data.begin() + old_size;
+			std::sort(middle, m_data.end(), m_compare);
+			std::inplace_merge(m_data.begin(), middle, m_data.end(), m_compare);
+		}
+
+		// Moves every element of other into this.
+		void merge(sorted_vector&& other)
+		{
+			if (&other == this)
+			{
+				return;
+			}
+			if (m_data.empty())
+			{
+				m_data = std::move(other.m_data);
+				m_sorted = other.m_sorted;
+			}
+			else
+			{
+				other.sort();
+				insert(std::make_move_iterator(other.m_data.begin()), std::make_move_iterator(other.m_data.end()));
+			}
+			other.clear();
+		}
+
+		void merge(const sorted_vector& other)
+		{
+			if (&other == this)
+			{
+				// insert can't take iterators into m_data itself.
+				merge(sorted_vector(other));
+				return;
+			}
+			other.sort();
+			insert(other.m_data.cbegin(), other.m_data.cend());
 		}
 
 		// Implies keep_sorted = true. Tries to insert just before hint.
@@ -281,40 +420,96 @@ namespace utils
 		auto crbegin() const { sort(); return m_data.crbegin(); }
 		auto crend() const { sort(); return m_data.crend(); }
 	};
+
+	// Set operations which take and return sorted_vectors. The result uses left's comparator.
+	template <typename T, typename Compare>
+	inline sorted_vector<T, Compare> set_intersection(const sorted_vector<T, Compare>& left, const sorted_vector<T, Compare>& right)
+	{
+		sorted_vector<T, Compare> result{ left.key_comp() };
+		result.reserve(std::min(left.size(), right.size()));
+		std::set_intersection(left.cbegin(), left.cend(), right.cbegin(), right.cend(), std::back_inserter(result), left.key_comp());
+		return result;
+	}
+
+	template <typename T, typename Compare>
+	inline sorted_vector<T, Compare> set_union(const sorted_vector<T, Compare>& left, const sorted_vector<T, Compare>& right)
+	{
+		sorted_vector<T, Compare> result{ left.key_comp() };
+		result.reserve(left.size() + right.size());
+		std::set_union(left.cbegin(), left.cend(), right.cbegin(), right.cend(), std::back_inserter(result), left.key_comp());
+		return result;
+	}
+
+	template <typename T, typename Compare>
+	inline sorted_vector<T, Compare> set_difference(const sorted_vector<T, Compare>& left, const sorted_vector<T, Compare>& right)
+	{
+		sorted_vector<T, Compare> result{ left.key_comp() };
+		result.reserve(left.size());
+		std::set_difference(left.cbegin(), left.cend(), right.cbegin(), right.cend(), std::back_inserter(result), left.key_comp());
+		return result;
+	}
+
+	// Orders pairs by their first member only, and allows lookup by just the key.
+	template <typename Key, typename Compare = std::less<Key>>
+	struct compare_first
+	{
+		using is_transparent = void;
+		Compare compare;
+
+		template <typename Pair1, typename Pair2>
+		bool operator()(const Pair1& left, const Pair2& right) const
+		{
+			return compare(left.first, right.first);
+		}
+		template <typename Pair>
+		bool operator()(const Pair& left, const Key& right) const
+		{
+			return compare(left.first, right);
+		}
+		template <typename Pair>
+		bool operator()(const Key& left, const Pair& right) const
+		{
+			return compare(left, right.first);
+		}
+	};
+
+	// A flat map. Use make_unique() after inserting to drop duplicate keys.
+	template <typename Key, typename Value, typename Compare = std::less<Key>>
+	using sorted_vector_map = sorted_vector<std::pair<Key, Value>, compare_first<Key, Compare>>;
 }
 
-template <typename T>
-inline auto begin(utils::sorted_vector<T>& sv) { return sv.begin(); }
+template <typename T, typename Compare>
+inline auto begin(utils::sorted_vector<T, Compare>& sv) { return sv.begin(); }
 
-template <typename T>
-inline auto begin(const utils::sorted_vector<T>& sv) { return sv.begin(); }
+template <typename T, typename Compare>
+inline auto begin(const utils::sorted_vector<T, Compare>& sv) { return sv.begin(); }
 
-template <typename T>
-inline auto end(utils::sorted_vector<T>& sv) { return sv.end(); }
+template <typename T, typename Compare>
+inline auto end(utils::sorted_vector<T, Compare>& sv) { return sv.end(); }
 
-template <typename T>
-inline auto end(const utils::sorted_vector<T>& sv) { return sv.end(); }
+template <typename T, typename Compare>
+inline auto end(const utils::sorted_vector<T, Compare>& sv) { return sv.end(); }
 
-template <typename T>
-inline auto rbegin(utils::sorted_vector<T>& sv) { return sv.rbegin(); }
+template <typename T, typename Compare>
+inline auto rbegin(utils::sorted_vector<T, Compare>& sv) { return sv.rbegin(); }
 
-template <typename T>
-inline auto rbegin(const utils::sorted_vector<T>& sv) { return sv.rbegin(); }
+template <typename T, typename Compare>
+inline auto rbegin(const utils::sorted_vector<T, Compare>& sv) { return sv.rbegin(); }
 
-template <typename T>
-inline auto rend(utils::sorted_vector<T>& sv) { return sv.rend(); }
+template <typename T, typename Compare>
+inline auto rend(utils::sorted_vector<T, Compare>& sv) { return sv.rend(); }
 
-template <typename T>
-inline auto rend(const utils::sorted_vector<T>& sv) { return sv.rend(); }
+template <typename T, typename Compare>
+inline auto rend(const utils::sorted_vector<T, Compare>& sv) { return sv.rend(); }
 
-template <typename T>
-inline auto cbegin(const utils::sorted_vector<T>& sv) { return sv.cbegin(); }
+template <typename T, typename Compare>
+inline auto cbegin(const utils::sorted_vector<T, Compare>& sv) { return sv.cbegin(); }
 
-template <typename T>
-inline auto cend(const utils::sorted_vector<T>& sv) { return sv.cend(); }
+template <typename T, typename Compare>
+inline auto cend(const utils::sorted_vector<T, Compare>& sv) { return sv.cend(); }
 
-template <typename T>
-inline auto crbegin(const utils::sorted_vector<T>& sv) { return sv.crbegin(); }
+template <typename T, typename Compare>
+inline auto crbegin(const utils::sorted_vector<T, Compare>& sv) { return sv.crbegin(); }
 
-template <typename T>
-inline auto crend(const utils::sorted_vector<T>& sv) { return sv.crend(); }
+template <typename T, typename Compare>
+inline auto crend(const utils::sorted_vector<T, Compare>& sv) { return sv.crend(); }
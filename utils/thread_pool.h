@@ -0,0 +1,367 @@
+#pragma once
+
+// A fixed set of worker threads to run tasks on.
+// Each worker has its own queue. New tasks from a worker go on the back of its own queue and it
+// takes work from there too, so related tasks tend to stay on one thread. A worker with nothing
+// to do steals from the front of the other queues.
+//
+// parallel_for and parallel_reduce split a range (anything with size() and operator[], such as
+// int_range or a vector) into chunks. The calling thread works through chunks alongside the
+// workers, so it is safe to call them from inside a task, and they still finish if every worker is busy.
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <future>
+#include <optional>
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <algorithm>
+#include <cstddef>
+#include <cassert>
+
+namespace utils
+{
+	namespace internals
+	{
+		// A move-only std::function<void()>, so it can hold a std::packaged_task.
+		class pool_task
+		{
+			struct task_base
+			{
+				virtual ~task_base() = default;
+				virtual void run() = 0;
+			};
+
+			template <typename Func>
+			struct task_impl : task_base
+			{
+				Func func;
+				explicit task_impl(Func&& f) : func{ std::move(f) } {}
+				void run() override { func(); }
+			};
+
+			std::unique_ptr<task_base> m_impl;
+		public:
+			pool_task() = default;
+			template <typename Func>
+			explicit pool_task(Func func) : m_impl{ std::make_unique<task_impl<Func>>(std::move(func)) } {}
+
+			void operator()() { m_impl->run(); }
+			explicit operator bool() const noexcept { return m_impl != nullptr; }
+		};
+
+		class work_queue
+		{
+			std::mutex m_mutex;
+			std::deque<pool_task> m_tasks;
+		public:
+			void push(pool_task task)
+			{
+				std::lock_guard lock{ m_mutex };
+				m_tasks.push_back(std::move(task));
+			}
+
+			// The owner takes the newest task.
+			pool_task try_pop()
+			{
+				std::lock_guard lock{ m_mutex };
+				if (m_tasks.empty()) return pool_task{};
+				pool_task result = std::move(m_tasks.back());
+				m_tasks.pop_back();
+				return result;
+			}
+
+			// Other threads take the oldest.
+			pool_task try_steal()
+			{
+				std::lock_guard lock{ m_mutex };
+				if (m_tasks.empty()) return pool_task{};
+				pool_task result = std::move(m_tasks.front());
+				m_tasks.pop_front();
+				return result;
+			}
+		};
+	}
+
+	class thread_pool
+	{
+		static constexpr std::size_t CHUNKS_PER_THREAD = 4;
+		static constexpr std::size_t NOT_A_WORKER = static_cast<std::size_t>(-1);
+
+		std::vector<std::unique_ptr<internals::work_queue>> m_queues;
+		std::vector<std::thread> m_threads;
+		std::atomic<std::size_t> m_num_queued{ 0 };
+		std::atomic<std::size_t> m_next_queue{ 0 };
+		std::mutex m_sleep_mutex;
+		std::condition_variable m_wake;
+		bool m_stopping = false;
+
+		inline static thread_local const thread_pool* t_current_pool = nullptr;
+		inline static thread_local std::size_t t_worker_index = NOT_A_WORKER;
+
+		std::size_t current_worker_index() const noexcept
+		{
+			return t_current_pool == this ? t_worker_index : NOT_A_WORKER;
+		}
+
+		void enqueue(internals::pool_task task)
+		{
+			const std::size_t worker = current_worker_index();
+			const std::size_t queue = worker != NOT_A_WORKER ? worker : m_next_queue++ % m_queues.size();
+			// Counted before it's pushed, so a worker taking it straight away can't take the count below zero.
+			++m_num_queued;
+			m_queues[queue]->push(std::move(task));
+			// Take the lock so the wake-up can't land between a worker checking for work and going to sleep.
+			{
+				std::lock_guard lock{ m_sleep_mutex };
+			}
+			m_wake.notify_one();
+		}
+
+		internals::pool_task find_task(std::size_t worker)
+		{
+			internals::pool_task result;
+			if (worker != NOT_A_WORKER)
+			{
+				result = m_queues[worker]->try_pop();
+			}
+			const std::size_t first = (worker != NOT_A_WORKER) ? worker + 1 : 0;
+			for (std::size_t i = 0; !result && i < m_queues.size(); ++i)
+			{
+				result = m_queues[(first + i) % m_queues.size()]->try_steal();
+			}
+			if (result)
+			{
+				--m_num_queued;
+			}
+			return result;
+		}
+
+		void worker_loop(std::size_t index)
+		{
+			t_current_pool = this;
+			t_worker_index = index;
+			while (true)
+			{
+				if (internals::pool_task task = find_task(index))
+				{
+					task();
+					continue;
+				}
+				std::unique_lock lock{ m_sleep_mutex };
+				m_wake.wait(lock, [this]() { return m_stopping || m_num_queued.load() > 0; });
+				if (m_stopping && m_num_queued.load() == 0)
+				{
+					return;
+				}
+			}
+		}
+
+		std::size_t num_chunks(std::size_t num_elements) const noexcept
+		{
+			return std::min(num_elements, (size() + 1) * CHUNKS_PER_THREAD);
+		}
+
+		// Calls chunk_func(chunk, first, last) for each chunk of [0, num_elements), and returns once every chunk is done.
+		// The workers only get a pointer to chunk_func, which is fine because they only use it
+		// after claiming a chunk, and this doesn't return until all the claimed chunks are finished.
+		template <typename ChunkFunc>
+		void run_chunked(std::size_t num_elements, const ChunkFunc& chunk_func)
+		{
+			struct shared_state
+			{
+				const ChunkFunc* func;
+				std::size_t num_elements;
+				std::size_t num_chunks;
+				std::atomic<std::size_t> next_chunk{ 0 };
+				std::atomic<std::size_t> chunks_done{ 0 };
+				std::atomic_flag failed;
+				std::exception_ptr exception;
+			};
+
+			const std::size_t total_chunks = num_chunks(num_elements);
+			if (total_chunks == 0)
+			{
+				return;
+			}
+			auto state = std::make_shared<shared_state>();
+			state->func = &chunk_func;
+			state->num_elements = num_elements;
+			state->num_chunks = total_chunks;
+
+			auto run_chunks = [state]()
+			{
+				while (true)
+				{
+					const std::size_t chunk = state->next_chunk++;
+					if (chunk >= state->num_chunks)
+					{
+						return;
+					}
+					const std::size_t first = state->num_elements * chunk / state->num_chunks;
+					const std::size_t last = state->num_elements * (chunk + 1) / state->num_chunks;
+					try
+					{
+						(*state->func)(chunk, first, last);
+					}
+					catch (...)
+					{
+						if (!state->failed.test_and_set())
+						{
+							state->exception = std::current_exception();
+						}
+					}
+					if (++state->chunks_done == state->num_chunks)
+					{
+						state->chunks_done.notify_all();
+					}
+				}
+			};
+
+			const std::size_t num_helpers = std::min(size(), total_chunks - 1);
+			for (std::size_t i = 0; i < num_helpers; ++i)
+			{
+				enqueue(internals::pool_task{ run_chunks });
+			}
+			run_chunks();
+
+			std::size_t done = state->chunks_done.load();
+			while (done != total_chunks)
+			{
+				state->chunks_done.wait(done);
+				done = state->chunks_done.load();
+			}
+			if (state->exception)
+			{
+				std::rethrow_exception(state->exception);
+			}
+		}
+
+	public:
+		// Leaves a core for the thread that hands out the work, but always has at least one worker.
+		static std::size_t default_num_threads() noexcept
+		{
+			return std::max(std::thread::hardware_concurrency(), 2u) - 1;
+		}
+
+		explicit thread_pool(std::size_t num_threads = default_num_threads())
+		{
+			assert(num_threads > 0);
+			m_queues.reserve(num_threads);
+			for (std::size_t i = 0; i < num_threads; ++i)
+			{
+				m_queues.push_back(std::make_unique<internals::work_queue>());
+			}
+			m_threads.reserve(num_threads);
+			for (std::size_t i = 0; i < num_threads; ++i)
+			{
+				m_threads.emplace_back([this, i]() { worker_loop(i); });
+			}
+		}
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+
+		// Runs any tasks still queued before returning.
+		~thread_pool()
+		{
+			{
+				std::lock_guard lock{ m_sleep_mutex };
+				m_stopping = true;
+			}
+			m_wake.notify_all();
+			for (auto& thread : m_threads)
+			{
+				thread.join();
+			}
+		}
+
+		std::size_t size() const noexcept { return m_threads.size(); }
+
+		// Exceptions thrown by func come out of the future's get().
+		// Don't wait on the future from inside another task: use run_pending_task while waiting,
+		// or parallel_for, so that a full pool doesn't wait on itself.
+		template <typename Func>
+		std::future<std::invoke_result_t<std::decay_t<Func>>> submit(Func&& func)
+		{
+			using Result = std::invoke_result_t<std::decay_t<Func>>;
+			std::packaged_task<Result()> task{ std::forward<Func>(func) };
+			auto result = task.get_future();
+			enqueue(internals::pool_task{ std::move(task) });
+			return result;
+		}
+
+		// Runs one queued task on this thread. Returns false if there wasn't one.
+		bool run_pending_task()
+		{
+			if (internals::pool_task task = find_task(current_worker_index()))
+			{
+				task();
+				return true;
+			}
+			return false;
+		}
+
+		// Calls func(range[i]) for every element, in no particular order.
+		// If func throws, one of the exceptions is rethrown here once every chunk has finished.
+		template <typename Range, typename Func>
+		void parallel_for(const Range& range, Func&& func)
+		{
+			run_chunked(range.size(), [&range, &func](std::size_t, std::size_t first, std::size_t last)
+			{
+				for (std::size_t i = first; i < last; ++i)
+				{
+					func(range[i]);
+				}
+			});
+		}
+
+		// Like std::transform_reduce: reduce_op must be associative, but need not be commutative,
+		// as the chunks are combined in order.
+		template <typename Range, typename T, typename ReduceOp, typename TransformOp>
+		T parallel_reduce(const Range& range, T init, ReduceOp reduce_op, TransformOp transform_op)
+		{
+			std::vector<std::optional<T>> partials(num_chunks(range.size()));
+			run_chunked(range.size(), [&](std::size_t chunk, std::size_t first, std::size_t last)
+			{
+				T partial = transform_op(range[first]);
+				for (std::size_t i = first + 1; i < last; ++i)
+				{
+					partial = reduce_op(std::move(partial), transform_op(range[i]));
+				}
+				partials[chunk].emplace(std::move(partial));
+			});
+			for (auto& partial : partials)
+			{
+				assert(partial.has_value());
+				init = reduce_op(std::move(init), std::move(*partial));
+			}
+			return init;
+		}
+	};
+
+	// Shared by everything that doesn't need a pool of its own. Started on first use.
+	inline thread_pool& default_thread_pool()
+	{
+		static thread_pool pool;
+		return pool;
+	}
+
+	template <typename Range, typename Func>
+	void parallel_for(const Range& range, Func&& func)
+	{
+		default_thread_pool().parallel_for(range, std::forward<Func>(func));
+	}
+
+	template <typename Range, typename T, typename ReduceOp, typename TransformOp>
+	T parallel_reduce(const Range& range, T init, ReduceOp reduce_op, TransformOp transform_op)
+	{
+		return default_thread_pool().parallel_reduce(range, std::move(init), std::move(reduce_op), std::move(transform_op));
+	}
+}
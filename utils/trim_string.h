@@ -1,6 +1,7 @@
 #pragma once
 
-#include <algorithm>
+#include "char_class.h"
+
 #include <string_view>
 
 namespace utils
@@ -9,14 +10,14 @@ namespace utils
 	{
 		inline std::size_t trim_left_result(const std::string_view& sv)
 		{
-			const auto left_it = std::find_if_not(begin(sv), end(sv), ::isspace);
-			return std::distance(begin(sv), left_it);
+			const std::size_t first = find_first_not_in(sv, space_chars);
+			return first == std::string_view::npos ? sv.size() : first;
 		}
 
 		inline std::size_t trim_right_result(const std::string_view& sv)
 		{
-			const auto right_it = std::find_if_not(rbegin(sv), rend(sv), ::isspace);
-			return std::distance(rbegin(sv), right_it);
+			const std::size_t last = find_last_not_in(sv, space_chars);
+			return last == std::string_view::npos ? sv.size() : sv.size() - last - 1;
 		}
 	}
 